@@ -0,0 +1,229 @@
+#include "zasm/machine/compiled.hh"
+#include "zasm/machine/machine.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+/**
+ * Runs a firmware recompiled by `zasm_recompile` side by side with the interpreter, comparing both machines after
+ * every slice of cycles.
+ *
+ * Built by `zasm_recompile` with `ZASM_AOT_SYMBOL`, `ZASM_AOT_FIRMWARE`, `ZASM_AOT_LOAD` and `ZASM_AOT_ENTRY`.
+ */
+extern const zasm::CompiledCode ZASM_AOT_SYMBOL;
+
+namespace
+{
+    struct Options
+    {
+        uint64_t cycles = 10000000;
+        uint64_t slice = 10007;
+        uint64_t interrupts = 0;
+        zasm::address_t stack = 0x0000;
+    };
+
+    void usage(const char* program)
+    {
+        std::cerr << "usage: " << program << " [options]\n"
+                  << "  --cycles N         the number of cycles to compare (default: 10000000)\n"
+                  << "  --slice N          the number of cycles between two comparisons (default: 10007)\n"
+                  << "  --interrupts N     raise an interrupt every N cycles (default: never)\n"
+                  << "  --stack ADDRESS    the initial stack pointer (default: 0x0000)\n";
+    }
+
+    /**
+     * Raises an interrupt every period, as a timer would.
+     */
+    void tick(zasm::Machine& machine, uint64_t cycle, uint64_t period)
+    {
+        machine.scheduler().schedule(cycle, [&machine, cycle, period]() {
+            machine.interrupt();
+            tick(machine, cycle + period, period);
+        });
+    }
+
+    std::unique_ptr<zasm::Machine> start(const std::vector<zasm::byte_t>& rom, const Options& options)
+    {
+        auto machine = std::make_unique<zasm::Machine>();
+
+        auto start = zasm::address_t(ZASM_AOT_LOAD);
+        auto end = start + rom.size();
+
+        std::shared_ptr<zasm::byte_t> memory(new zasm::byte_t[rom.size()], std::default_delete<zasm::byte_t[]>());
+        std::copy(rom.begin(), rom.end(), memory.get());
+
+        machine->bus().attach<zasm::ROM>(start, end, std::move(memory));
+        if (start > 0)
+        {
+            machine->bus().attach<zasm::RAM>(0x0000, start);
+        }
+        if (end < zasm::ADDRESS_SPACE)
+        {
+            machine->bus().attach<zasm::RAM>(zasm::address_t(end), zasm::ADDRESS_SPACE);
+        }
+
+        machine->cpu().write(zasm::PC, zasm::address_t(ZASM_AOT_ENTRY));
+        machine->cpu().write(zasm::SP, options.stack);
+
+        if (options.interrupts != 0)
+        {
+            tick(*machine, options.interrupts, options.interrupts);
+        }
+
+        return machine;
+    }
+
+    /**
+     * Describes how two machines differ, if they do.
+     */
+    std::string compare(const zasm::Machine& interpreted, const zasm::Machine& compiled)
+    {
+        static const char* const names[] = {
+            "AF", "BC", "DE", "HL", "AF'", "BC'", "DE'", "HL'", "IR", "IX", "IY", "SP", "PC",
+        };
+
+        std::string difference;
+
+        for (size_t r = 0; r <= zasm::PC; ++r)
+        {
+            auto expected = interpreted.cpu().read(zasm::WordRegister(r));
+            auto actual = compiled.cpu().read(zasm::WordRegister(r));
+
+            if (expected != actual)
+            {
+                difference += std::string(" ") + names[r] + " " + std::to_string(expected) + " != "
+                              + std::to_string(actual);
+            }
+        }
+
+        if (interpreted.cpu().iff1() != compiled.cpu().iff1() || interpreted.cpu().iff2() != compiled.cpu().iff2())
+        {
+            difference += " IFF";
+        }
+
+        if (interpreted.cpu().halted() != compiled.cpu().halted())
+        {
+            difference += " HALT";
+        }
+
+        if (interpreted.cycles() != compiled.cycles())
+        {
+            difference += " cycles " + std::to_string(interpreted.cycles()) + " != "
+                          + std::to_string(compiled.cycles());
+        }
+
+        std::vector<zasm::byte_t> expected(zasm::ADDRESS_SPACE);
+        std::vector<zasm::byte_t> actual(zasm::ADDRESS_SPACE);
+        interpreted.bus().read_span(0x0000, expected.data(), expected.size());
+        compiled.bus().read_span(0x0000, actual.data(), actual.size());
+
+        for (size_t address = 0; address < expected.size(); ++address)
+        {
+            if (expected[address] != actual[address])
+            {
+                difference += " memory at " + std::to_string(address);
+                break;
+            }
+        }
+
+        return difference;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto option = [&](const char* name) {
+            return std::strcmp(argv[i], name) == 0 && i + 1 < argc;
+        };
+
+        if (option("--cycles"))
+        {
+            options.cycles = std::strtoull(argv[++i], nullptr, 0);
+        }
+        else if (option("--slice"))
+        {
+            options.slice = std::max<uint64_t>(1, std::strtoull(argv[++i], nullptr, 0));
+        }
+        else if (option("--interrupts"))
+        {
+            options.interrupts = std::strtoull(argv[++i], nullptr, 0);
+        }
+        else if (option("--stack"))
+        {
+            options.stack = zasm::address_t(std::strtoul(argv[++i], nullptr, 0));
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ifstream file(ZASM_AOT_FIRMWARE, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << ZASM_AOT_FIRMWARE << ": cannot open file\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<zasm::byte_t> rom;
+    rom.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    auto interpreted = start(rom, options);
+    auto compiled = start(rom, options);
+
+    if (!compiled->attach(&ZASM_AOT_SYMBOL))
+    {
+        std::cerr << ZASM_AOT_FIRMWARE << ": does not match the recompiled firmware\n";
+        return EXIT_FAILURE;
+    }
+
+    std::chrono::steady_clock::duration interpreting{};
+    std::chrono::steady_clock::duration running{};
+
+    while (interpreted->cycles() < options.cycles)
+    {
+        auto first = std::chrono::steady_clock::now();
+        auto expected = interpreted->run(options.slice);
+        auto second = std::chrono::steady_clock::now();
+        auto actual = compiled->run(options.slice);
+        auto third = std::chrono::steady_clock::now();
+
+        interpreting += second - first;
+        running += third - second;
+
+        auto difference = compare(*interpreted, *compiled);
+        if (!difference.empty())
+        {
+            std::cerr << "diverged before cycle " << interpreted->cycles() << ":" << difference << '\n';
+            return EXIT_FAILURE;
+        }
+
+        if (expected < options.slice || actual < options.slice)
+        {
+            std::cerr << "stopped on an unimplemented instruction at " << interpreted->cpu().read(zasm::PC) << '\n';
+            break;
+        }
+    }
+
+    auto mhz = [](uint64_t cycles, std::chrono::steady_clock::duration duration) {
+        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        return double(cycles) / std::max(1.0, double(microseconds));
+    };
+
+    std::cerr << "no divergence over " << interpreted->cycles() << " cycles, interpreted at "
+              << mhz(interpreted->cycles(), interpreting) << " MHz, recompiled at "
+              << mhz(compiled->cycles(), running) << " MHz\n";
+
+    return EXIT_SUCCESS;
+}
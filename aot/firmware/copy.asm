@@ -0,0 +1,31 @@
+; The source of copy.bin, a firmware recompiled by zasm_recompile and compared against the interpreter by ctest.
+;
+; It fills a page of RAM from the refresh register, then copies it through a subroutine, forever.  The listing gives
+; the address and encoding of every instruction, as zasm does not assemble it.
+
+        org     0x0000
+
+start:  ld      sp, 0x0000      ; 0000  31 00 00
+
+fill:   ld      hl, 0x8000      ; 0003  21 00 80
+        ld      b, 0            ; 0006  06 00
+.next:  ld      a, r            ; 0008  ED 5F
+        and     0x3F            ; 000A  E6 3F
+        ld      (hl), a         ; 000C  77
+        inc     hl              ; 000D  23
+        djnz    .next           ; 000E  10 F8
+
+        ld      hl, 0x8000      ; 0010  21 00 80
+        ld      de, 0x9000      ; 0013  11 00 90
+        ld      b, 0            ; 0016  06 00
+.copy:  call    move            ; 0018  CD 25 00
+        inc     hl              ; 001B  23
+        inc     de              ; 001C  13
+        djnz    .copy           ; 001D  10 F9
+
+        ld      a, (0x9000)     ; 001F  3A 00 90
+        jp      fill            ; 0022  C3 03 00
+
+move:   ld      a, (hl)         ; 0025  7E
+        ld      (de), a         ; 0026  12
+        ret                     ; 0027  C9
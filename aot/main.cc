@@ -0,0 +1,107 @@
+#include "recompiler.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+    void usage(const char* program)
+    {
+        std::cerr << "usage: " << program << " [options] <firmware>\n"
+                  << "  --load ADDRESS     where the firmware is loaded (default: 0x0000)\n"
+                  << "  --entry ADDRESS    where to start walking the firmware, in addition to the vectors\n"
+                  << "  --no-vectors       do not walk the restart and interrupt vectors\n"
+                  << "  --symbol NAME      the name of the generated zasm::CompiledCode (default: firmware)\n"
+                  << "  --output FILE      where to write the generated C++ (default: the standard output)\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    zasm::aot::Options options;
+
+    const char* firmware = nullptr;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto option = [&](const char* name) {
+            return std::strcmp(argv[i], name) == 0 && i + 1 < argc;
+        };
+
+        if (option("--load"))
+        {
+            options.load = zasm::address_t(std::strtoul(argv[++i], nullptr, 0));
+        }
+        else if (option("--entry"))
+        {
+            options.entries.push_back(zasm::address_t(std::strtoul(argv[++i], nullptr, 0)));
+        }
+        else if (std::strcmp(argv[i], "--no-vectors") == 0)
+        {
+            options.vectors = false;
+        }
+        else if (option("--symbol"))
+        {
+            options.symbol = argv[++i];
+        }
+        else if (option("--output"))
+        {
+            path = argv[++i];
+        }
+        else if (argv[i][0] != '-' && firmware == nullptr)
+        {
+            firmware = argv[i];
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (firmware == nullptr)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(firmware, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << firmware << ": cannot open file\n";
+        return EXIT_FAILURE;
+    }
+
+    options.firmware.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    options.source = firmware;
+
+    if (options.firmware.empty() || options.load + options.firmware.size() > zasm::ADDRESS_SPACE)
+    {
+        std::cerr << firmware << ": does not fit in the address space\n";
+        return EXIT_FAILURE;
+    }
+
+    zasm::aot::Recompiler recompiler(std::move(options));
+
+    if (path == nullptr)
+    {
+        recompiler.write(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    std::ofstream output(path);
+    recompiler.write(output);
+
+    if (!output)
+    {
+        std::cerr << path << ": cannot write file\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << path << ": " << recompiler.instructions() << " instructions recompiled\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,293 @@
+#include "recompiler.hh"
+
+#include "meta.hh"
+
+#include "zasm/machine/bus.hh"
+#include "zasm/machine/compiled.hh"
+#include "zasm/machine/cpu.hh"
+
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <utility>
+
+namespace zasm::aot
+{
+    namespace
+    {
+        /**
+         * The restart vectors, followed by the vector of non-maskable interrupts.
+         */
+        constexpr address_t VECTORS[] = { 0x00, 0x08, 0x10, 0x18, 0x20, 0x28, 0x30, 0x38, 0x66 };
+
+        /**
+         * The longest instruction, so that instructions ending the firmware are not read past its end.
+         */
+        constexpr size_t MAX_LENGTH = 4;
+
+        std::string hex(uint64_t value, int digits = 4)
+        {
+            char text[24];
+            std::snprintf(text, sizeof(text), "0x%0*llX", digits, static_cast<unsigned long long>(value));
+            return text;
+        }
+
+        /**
+         * A bus component taking every write away from the firmware, remembering them.
+         */
+        class Recorder final : public BusComponent
+        {
+        private:
+            std::vector<std::pair<address_t, byte_t>> _writes;
+
+        public:
+            void clear() noexcept
+            {
+                _writes.clear();
+            }
+
+            /**
+             * Gets the word written at an address, if both of its bytes were written.
+             */
+            [[nodiscard]] std::optional<word_t> written(address_t address) const noexcept
+            {
+                std::optional<byte_t> low;
+                std::optional<byte_t> high;
+
+                for (const auto& [target, byte] : _writes)
+                {
+                    if (target == address)
+                    {
+                        low = byte;
+                    }
+                    else if (target == address_t(address + 1))
+                    {
+                        high = byte;
+                    }
+                }
+
+                if (!low || !high)
+                {
+                    return std::nullopt;
+                }
+
+                return word_t(*low | (*high << 8u));
+            }
+
+            [[nodiscard]] byte_t read(address_t address) const noexcept override
+            {
+                UNUSED(address);
+                return 0;
+            }
+
+            void write(address_t address, byte_t byte) noexcept override
+            {
+                _writes.emplace_back(address, byte);
+            }
+
+            [[nodiscard]] bool accept_write(address_t address) const noexcept override
+            {
+                UNUSED(address);
+                return true;
+            }
+        };
+
+        /**
+         * What running an instruction on a scratch CPU did.
+         */
+        struct Outcome
+        {
+            address_t pc;
+            bool halted;
+            std::optional<word_t> pushed;
+        };
+
+        Outcome probe(const Opcode& opcode, Bus& bus, Recorder& recorder, address_t address, byte_t flags,
+                      byte_t counter, word_t other)
+        {
+            CPU cpu;
+            for (auto rr : { AF, BC, DE, HL, AF_, BC_, DE_, HL_, IR, IX, IY, SP })
+            {
+                cpu.write(rr, other);
+            }
+
+            cpu.write(F, flags);
+            cpu.write(B, counter);
+            cpu.write(PC, address);
+
+            recorder.clear();
+            opcode.execute(cpu, bus);
+
+            return Outcome{ cpu.read(PC), cpu.halted(), recorder.written(cpu.read(SP)) };
+        }
+    }
+
+    Recompiler::Recompiler(Options options)
+        : _options(std::move(options))
+        , _instructions()
+    {
+        auto start = _options.load;
+        auto end = start + _options.firmware.size();
+
+        std::shared_ptr<byte_t> memory(new byte_t[end - start](), std::default_delete<byte_t[]>());
+        std::copy(_options.firmware.begin(), _options.firmware.end(), memory.get());
+
+        Bus bus;
+        bus.attach<ROM>(start, end, std::move(memory));
+        auto& recorder = bus.attach<Recorder>();
+
+        std::vector<address_t> pending(_options.entries.rbegin(), _options.entries.rend());
+        if (_options.vectors)
+        {
+            pending.insert(pending.begin(), std::begin(VECTORS), std::end(VECTORS));
+        }
+
+        const auto& decoder = Decoder::instance();
+
+        while (!pending.empty())
+        {
+            auto address = pending.back();
+            pending.pop_back();
+
+            if (address < start || address >= end || _instructions.count(address) != 0)
+            {
+                continue;
+            }
+
+            const auto* opcode = decoder.decode(bus, address);
+            if (opcode == nullptr)
+            {
+                continue;
+            }
+
+            // Flags and B are set both ways to take every branch of conditional instructions, while the other
+            // registers, including SP, are changed to find which branches depend on them.
+            std::set<address_t> successors;
+            std::optional<word_t> pushed;
+            auto halts = false;
+
+            for (auto [flags, counter] : { std::pair<byte_t, byte_t>{ 0x00, 1 }, { 0xFF, 2 } })
+            {
+                auto first = probe(*opcode, bus, recorder, address, flags, counter, 0x0000);
+                auto second = probe(*opcode, bus, recorder, address, flags, counter, 0x5A5A);
+
+                if (first.pc == second.pc)
+                {
+                    successors.insert(first.pc);
+                }
+
+                halts = halts || first.halted;
+                pushed = pushed ? pushed : first.pushed;
+            }
+
+            Instruction instruction;
+            instruction.opcode = opcode;
+            instruction.halts = halts;
+
+            if (opcode->flow == Flow::Next)
+            {
+                if (successors.size() != 1 || *successors.begin() <= address || *successors.begin() > end)
+                {
+                    continue;
+                }
+
+                instruction.next = *successors.begin();
+            }
+            else if (address + MAX_LENGTH > end)
+            {
+                continue;
+            }
+
+            if (opcode->flow == Flow::Call && pushed)
+            {
+                successors.insert(*pushed);
+            }
+
+            _instructions.emplace(address, instruction);
+            pending.insert(pending.end(), successors.rbegin(), successors.rend());
+        }
+    }
+
+    void Recompiler::write(std::ostream& output) const
+    {
+        auto start = _options.load;
+        auto end = start + _options.firmware.size();
+        auto checksum = CompiledCode::hash(_options.firmware.data(), _options.firmware.size());
+        const auto& decoder = Decoder::instance();
+
+        output << "// Recompiled by zasm_aot from " << _options.source << ", do not edit.\n"
+               << "// " << _instructions.size() << " instructions reachable from the firmware loaded at "
+               << hex(start) << ".\n"
+               << "\n"
+               << "#include \"zasm/machine/compiled.hh\"\n"
+               << "\n"
+               << "#include \"machine/instructions.hh\"\n"
+               << "\n"
+               << "namespace\n"
+               << "{\n"
+               << "    using namespace zasm;\n"
+               << "\n"
+               << "    void run(CompiledContext& context)\n"
+               << "    {\n"
+               << "        auto& cpu = context.cpu;\n";
+
+        if (!_instructions.empty())
+        {
+            output << "        auto& bus = context.bus;\n";
+        }
+
+        output << "\n"
+               << "        for (;;)\n"
+               << "        {\n"
+               << "            switch (cpu.read(PC))\n"
+               << "            {\n";
+
+        for (auto it = _instructions.begin(); it != _instructions.end(); ++it)
+        {
+            const auto& [address, instruction] = *it;
+            const auto& opcode = *instruction.opcode;
+
+            auto following = std::next(it);
+            auto falls = instruction.next && following != _instructions.end() && following->first == *instruction.next;
+
+            output << "                case " << hex(address) << ":\n"
+                   << "                    context.fetch(" << int(opcode.fetches) << ");\n"
+                   << "                    context.retire(" << decoder.handler(opcode) << "(cpu, bus));\n";
+
+            if (opcode.delaysInterrupts)
+            {
+                output << "                    context.deferred = true;\n"
+                       << "                    return;\n";
+                continue;
+            }
+
+            if (instruction.halts)
+            {
+                output << "                    if (cpu.halted())\n"
+                       << "                    {\n"
+                       << "                        return;\n"
+                       << "                    }\n";
+            }
+
+            output << "                    if (context.exhausted())\n"
+                   << "                    {\n"
+                   << "                        return;\n"
+                   << "                    }\n"
+                   << (falls ? "                    [[fallthrough]];\n" : "                    continue;\n");
+        }
+
+        output << "                default:\n"
+               << "                    return;\n"
+               << "            }\n"
+               << "        }\n"
+               << "    }\n"
+               << "}\n"
+               << "\n"
+               << "extern const zasm::CompiledCode " << _options.symbol << " = {\n"
+               << "    " << hex(start) << ",\n"
+               << "    " << hex(end, 5) << ",\n"
+               << "    " << hex(checksum, 16) << "u,\n"
+               << "    run,\n"
+               << "};\n";
+    }
+}
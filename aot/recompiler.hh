@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef __ZASM__AOT__RECOMPILER__
+#define __ZASM__AOT__RECOMPILER__
+
+#include "zasm/types.hh"
+
+#include "machine/decoder.hh"
+
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace zasm::aot
+{
+    struct Options
+    {
+        /**
+         * The firmware to recompile, held in ROM.
+         */
+        std::vector<byte_t> firmware;
+
+        /**
+         * The address at which the firmware is loaded.
+         */
+        address_t load = 0x0000;
+
+        /**
+         * The addresses from which to walk the firmware, in addition to the restart and interrupt vectors.
+         */
+        std::vector<address_t> entries;
+
+        /**
+         * Indicates if the restart and interrupt vectors within the firmware are walked.
+         */
+        bool vectors = true;
+
+        /**
+         * The name of the generated `CompiledCode`.
+         */
+        std::string symbol = "firmware";
+
+        /**
+         * The name of the firmware, mentioned in the generated code.
+         */
+        std::string source;
+    };
+
+    /**
+     * An instruction reachable from the entry points of the firmware.
+     */
+    struct Instruction
+    {
+        const Opcode* opcode = nullptr;
+
+        /**
+         * The address of the instruction executed next when this one does not transfer control, if any.
+         */
+        std::optional<address_t> next;
+
+        /**
+         * Indicates if the CPU may halt after this instruction.
+         */
+        bool halts = false;
+    };
+
+    /**
+     * Translates the instructions of a firmware reachable from its entry points to C++.
+     *
+     * The firmware is walked by running each instruction on scratch CPUs in a few states, so that the successors of
+     * conditional branches are all found, and indirect branches are told apart from direct ones.  Indirect branches
+     * and returns are left to the dispatch of the generated code, which falls back to the interpreter when they reach
+     * an address that was not recompiled.
+     */
+    class Recompiler final
+    {
+    private:
+        Options _options;
+        std::map<address_t, Instruction> _instructions;
+
+    public:
+        /**
+         * Walks the firmware from its entry points.
+         * @param options The firmware and where to start walking it
+         */
+        explicit Recompiler(Options options);
+
+        [[nodiscard]] inline size_t instructions() const noexcept
+        {
+            return _instructions.size();
+        }
+
+        /**
+         * Writes a C++ source file defining the recompiled code as a `zasm::CompiledCode`.
+         * @param output The stream to which to write
+         */
+        void write(std::ostream& output) const;
+    };
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include "harness.hh"
+
+#include "zasm/machine/bus.hh"
+#include "zasm/machine/dma.hh"
+
+#include <vector>
+
+namespace zasm::bench
+{
+    namespace
+    {
+        /**
+         * Creates a bus whose address space is evenly shared by the given number of RAM components.
+         */
+        Bus make_bus(size_t components)
+        {
+            Bus bus;
+
+            auto size = ADDRESS_SPACE / components;
+            for (size_t i = 0; i < components; ++i)
+            {
+                bus.attach<RAM>(address_t(i * size), (i + 1) * size);
+            }
+
+            return bus;
+        }
+    }
+
+    void register_bus(Harness& harness)
+    {
+        for (size_t components : { 1, 4, 16 })
+        {
+            auto suffix = "/" + std::to_string(components);
+
+            harness.operations("bus.read.byte" + suffix, [components](uint64_t iterations) {
+                auto bus = make_bus(components);
+
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    sum += bus.read<byte_t>(address_t(i));
+                }
+
+                keep(sum);
+                return iterations;
+            });
+
+            harness.operations("bus.read.word" + suffix, [components](uint64_t iterations) {
+                auto bus = make_bus(components);
+
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    sum += bus.read<word_t>(address_t(i));
+                }
+
+                keep(sum);
+                return iterations;
+            });
+
+            harness.operations("bus.write.byte" + suffix, [components](uint64_t iterations) {
+                auto bus = make_bus(components);
+
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    bus.write(address_t(i), byte_t(i));
+                }
+
+                keep(bus.read<byte_t>(0));
+                return iterations;
+            });
+
+            harness.operations("bus.read.span64k" + suffix, [components](uint64_t iterations) {
+                auto bus = make_bus(components);
+                std::vector<byte_t> bytes(ADDRESS_SPACE);
+
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    bus.read_span(address_t(i), bytes.data(), bytes.size());
+                }
+
+                keep(bytes[0]);
+                return iterations;
+            });
+
+            harness.operations("bus.write.span64k" + suffix, [components](uint64_t iterations) {
+                auto bus = make_bus(components);
+                std::vector<byte_t> bytes(ADDRESS_SPACE, byte_t(0x55));
+
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    bus.write_span(address_t(i), bytes.data(), bytes.size());
+                }
+
+                keep(bus.read<byte_t>(0));
+                return iterations;
+            });
+
+            harness.operations("bus.write.word" + suffix, [components](uint64_t iterations) {
+                auto bus = make_bus(components);
+
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    bus.write(address_t(i), word_t(i));
+                }
+
+                keep(bus.read<byte_t>(0));
+                return iterations;
+            });
+        }
+
+        harness.operations("dma.transfer64k", [](uint64_t iterations) {
+            auto bus = make_bus(1);
+            auto& dma = bus.attach<DMA>(bus, 0xFFF0);
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                dma.transfer(address_t(i), address_t(i + 0x8000), ADDRESS_SPACE);
+            }
+
+            keep(bus.read<byte_t>(0));
+            return iterations;
+        });
+    }
+}
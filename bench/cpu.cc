@@ -0,0 +1,76 @@
+#include "harness.hh"
+
+#include "zasm/machine/cpu.hh"
+
+namespace zasm::bench
+{
+    void register_cpu(Harness& harness)
+    {
+        harness.operations("cpu.read.byte", [](uint64_t iterations) {
+            static constexpr ByteRegister registers[] = { A, F, B, C, D, E, H, L };
+
+            CPU cpu;
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                sum += cpu.read(registers[i & 7u]);
+            }
+
+            keep(sum);
+            return iterations;
+        });
+
+        harness.operations("cpu.write.byte", [](uint64_t iterations) {
+            static constexpr ByteRegister registers[] = { A, F, B, C, D, E, H, L };
+
+            CPU cpu;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                cpu.write(registers[i & 7u], byte_t(i));
+            }
+
+            keep(cpu.read(A));
+            return iterations;
+        });
+
+        harness.operations("cpu.read.word", [](uint64_t iterations) {
+            static constexpr WordRegister registers[] = { AF, BC, DE, HL, IX, IY, SP, PC };
+
+            CPU cpu;
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                sum += cpu.read(registers[i & 7u]);
+            }
+
+            keep(sum);
+            return iterations;
+        });
+
+        harness.operations("cpu.write.word", [](uint64_t iterations) {
+            static constexpr WordRegister registers[] = { AF, BC, DE, HL, IX, IY, SP, PC };
+
+            CPU cpu;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                cpu.write(registers[i & 7u], word_t(i));
+            }
+
+            keep(cpu.read(HL));
+            return iterations;
+        });
+
+        harness.operations("cpu.flags", [](uint64_t iterations) {
+            CPU cpu;
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                cpu.set(Flag::Z, (i & 1u) != 0);
+                sum += cpu.get(Flag::Z);
+            }
+
+            keep(sum);
+            return iterations;
+        });
+    }
+}
@@ -0,0 +1,113 @@
+#include "harness.hh"
+
+#include "zasm/machine/machine.hh"
+
+#include <memory>
+#include <vector>
+
+namespace zasm::bench
+{
+    namespace
+    {
+        /**
+         * The size of the code executed by the dispatch benchmarks, which stays well within the caches of the host.
+         */
+        constexpr address_t CODE_SIZE = 0x1000;
+
+        /**
+         * Creates a machine with 64K of RAM, prepared out of the timing of the benchmarks.
+         */
+        std::unique_ptr<Machine> create()
+        {
+            auto machine = std::make_unique<Machine>();
+            machine->bus().attach<RAM>(0x0000, ADDRESS_SPACE);
+            return machine;
+        }
+
+        /**
+         * Executes the given number of instructions of a program looping over the same instruction.
+         */
+        uint64_t execute(Machine& machine, uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                machine.step();
+            }
+
+            keep(machine.cpu().read(A));
+            return iterations;
+        }
+
+        /**
+         * Registers a benchmark repeating the same instruction until the end of the code, then jumping back.
+         */
+        void repeat(Harness& harness, const std::string& family, std::vector<byte_t> instruction)
+        {
+            auto machine = std::make_shared<std::unique_ptr<Machine>>();
+
+            harness.operations("dispatch." + family, [machine, instruction]() {
+                *machine = create();
+                (*machine)->cpu().write(HL, 0x8000);
+                (*machine)->cpu().write(IX, 0x8000);
+                (*machine)->cpu().write(SP, 0xF000);
+
+                address_t address = 0;
+                while (address + instruction.size() + 3 <= CODE_SIZE)
+                {
+                    for (auto byte : instruction)
+                    {
+                        (*machine)->bus().write(address++, byte);
+                    }
+                }
+                load((*machine)->bus(), address, { 0xC3, 0x00, 0x00 });
+            }, [machine](uint64_t iterations) {
+                return execute(**machine, iterations);
+            });
+        }
+    }
+
+    void register_dispatch(Harness& harness)
+    {
+        repeat(harness, "nop", { 0x00 });
+        repeat(harness, "ld_r_r", { 0x78 });
+        repeat(harness, "ld_r_n", { 0x06, 0x12 });
+        repeat(harness, "ld_r_(hl)", { 0x7E });
+        repeat(harness, "ld_(hl)_r", { 0x77 });
+        repeat(harness, "ld_r_(ix+d)", { 0xDD, 0x7E, 0x00 });
+        repeat(harness, "ld_a_i", { 0xED, 0x57 });
+        repeat(harness, "ld_rr_nn", { 0x01, 0x34, 0x12 });
+        repeat(harness, "inc_rr", { 0x13 });
+
+        auto jumps = std::make_shared<std::unique_ptr<Machine>>();
+
+        harness.operations("dispatch.jp_nn", [jumps]() {
+            *jumps = create();
+
+            for (address_t address = 0; address + 3 <= CODE_SIZE; address += 3)
+            {
+                auto target = address + 6 <= CODE_SIZE ? address_t(address + 3) : address_t(0);
+                load((*jumps)->bus(), address, { 0xC3, byte_t(target & 0xFFu), byte_t(target >> 8u) });
+            }
+        }, [jumps](uint64_t iterations) {
+            return execute(**jumps, iterations);
+        });
+
+        auto calls = std::make_shared<std::unique_ptr<Machine>>();
+
+        harness.operations("dispatch.call_ret", [calls]() {
+            *calls = create();
+            (*calls)->cpu().write(SP, 0xF000);
+
+            address_t address = 0;
+            while (address + 6 <= CODE_SIZE)
+            {
+                load((*calls)->bus(), address, { 0xCD, 0x00, 0x20 });
+                address += 3;
+            }
+            load((*calls)->bus(), address, { 0xC3, 0x00, 0x00 });
+            load((*calls)->bus(), 0x2000, { 0xC9 });
+        }, [calls](uint64_t iterations) {
+            return execute(**calls, iterations);
+        });
+    }
+}
@@ -0,0 +1,139 @@
+#include "harness.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#ifndef ZASM_BENCH_VERSION
+#define ZASM_BENCH_VERSION "unknown"
+#endif
+
+#ifndef ZASM_BENCH_BUILD_TYPE
+#define ZASM_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace zasm::bench
+{
+    namespace
+    {
+        volatile uint64_t sink;
+
+        /**
+         * The most iterations a benchmark is calibrated to.
+         */
+        constexpr uint64_t MAX_ITERATIONS = uint64_t(1) << 40u;
+
+        uint64_t elapsed(const Harness::Setup& setup, const Harness::Body& body, uint64_t iterations, uint64_t& units)
+        {
+            if (setup)
+            {
+                setup();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            units = body(iterations);
+            auto end = std::chrono::steady_clock::now();
+
+            auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            return std::max<uint64_t>(uint64_t(nanoseconds), 1);
+        }
+    }
+
+    void keep(uint64_t value) noexcept
+    {
+        sink = sink + value;
+    }
+
+    void load(Bus& bus, address_t address, std::initializer_list<byte_t> bytes) noexcept
+    {
+        bus.write_span(address, bytes.begin(), bytes.size());
+    }
+
+    Harness::Harness(std::ostream& output, std::string filter, size_t repetitions, uint64_t nanoseconds)
+        : _output(output)
+        , _filter(std::move(filter))
+        , _repetitions(std::max<size_t>(repetitions, 1))
+        , _nanoseconds(nanoseconds)
+    {
+    }
+
+    void Harness::context()
+    {
+        _output << "{\"context\":{\"version\":\"" << ZASM_BENCH_VERSION << "\""
+                << ",\"build\":\"" << ZASM_BENCH_BUILD_TYPE << "\""
+                << ",\"repetitions\":" << _repetitions
+                << ",\"target_ns\":" << _nanoseconds << "}}\n";
+    }
+
+    void Harness::operations(const std::string& name, const Body& body)
+    {
+        measure(name, "ns/op", false, nullptr, body);
+    }
+
+    void Harness::emulation(const std::string& name, const Body& body)
+    {
+        measure(name, "MHz", true, nullptr, body);
+    }
+
+    void Harness::emulation(const std::string& name, const Setup& setup, const Body& body)
+    {
+        measure(name, "MHz", true, setup, body);
+    }
+
+    void Harness::operations(const std::string& name, const Setup& setup, const Body& body)
+    {
+        measure(name, "ns/op", false, setup, body);
+    }
+
+    void Harness::measure(const std::string& name, const char* metric, bool perNanosecond, const Setup& setup,
+                          const Body& body)
+    {
+        if (name.find(_filter) == std::string::npos)
+        {
+            return;
+        }
+
+        uint64_t units = 0;
+
+        // Grows the iterations until a run is long enough for its duration to be extrapolated.
+        uint64_t iterations = 1;
+        auto nanoseconds = elapsed(setup, body, iterations, units);
+        while (nanoseconds < _nanoseconds / 10 && iterations < MAX_ITERATIONS)
+        {
+            iterations *= 10;
+            nanoseconds = elapsed(setup, body, iterations, units);
+        }
+
+        // Bodies optimized away take next to no time, so the extrapolation is capped rather than overflowing.
+        auto extrapolated = double(iterations) * double(_nanoseconds) / double(std::max<uint64_t>(nanoseconds, 1));
+        iterations = uint64_t(std::clamp(extrapolated, 1.0, double(MAX_ITERATIONS)));
+
+        std::vector<double> samples;
+        for (size_t repetition = 0; repetition < _repetitions; ++repetition)
+        {
+            nanoseconds = elapsed(setup, body, iterations, units);
+            units = std::max<uint64_t>(units, 1);
+
+            if (perNanosecond)
+            {
+                samples.push_back(double(units) * 1000.0 / double(nanoseconds));
+            }
+            else
+            {
+                samples.push_back(double(nanoseconds) / double(units));
+            }
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        _output << "{\"benchmark\":\"" << name << "\""
+                << ",\"metric\":\"" << metric << "\""
+                << ",\"median\":" << samples[samples.size() / 2]
+                << ",\"min\":" << samples.front()
+                << ",\"max\":" << samples.back()
+                << ",\"iterations\":" << iterations
+                << ",\"units\":" << units << "}\n";
+        _output.flush();
+    }
+}
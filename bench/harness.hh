@@ -0,0 +1,113 @@
+#pragma once
+
+#ifndef __ZASM__BENCH__HARNESS__
+#define __ZASM__BENCH__HARNESS__
+
+#include "zasm/machine/bus.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+
+namespace zasm::bench
+{
+    /**
+     * Prevents the compiler from optimizing away the computation of a value.
+     * @param value A value
+     */
+    void keep(uint64_t value) noexcept;
+
+    /**
+     * Writes a program to a bus.
+     * @param bus A bus
+     * @param address The address of the first byte of the program
+     * @param bytes The bytes of the program
+     */
+    void load(Bus& bus, address_t address, std::initializer_list<byte_t> bytes) noexcept;
+
+    /**
+     * Measures benchmarks and reports their results as JSON lines.
+     *
+     * A benchmark body is given a number of iterations to execute and returns how many units of work were done,
+     * either operations or emulated cycles.  Every benchmark is calibrated so that a repetition lasts long enough
+     * to be measured reliably, then repeated, and the minimum, median and maximum of the repetitions are reported.
+     */
+    class Harness final
+    {
+    public:
+        using Body = std::function<uint64_t(uint64_t iterations)>;
+
+        /**
+         * Prepares a timed call of a body, without being timed itself.
+         */
+        using Setup = std::function<void()>;
+
+    private:
+        std::ostream& _output;
+        std::string _filter;
+        size_t _repetitions;
+        uint64_t _nanoseconds;
+
+    public:
+        /**
+         * Creates a new harness.
+         * @param output The stream to which results are written
+         * @param filter Only benchmarks whose name contains this string are run
+         * @param repetitions The number of measured repetitions of every benchmark
+         * @param nanoseconds The target duration of a single repetition
+         */
+        Harness(std::ostream& output, std::string filter, size_t repetitions, uint64_t nanoseconds);
+
+        /**
+         * Writes the context of the results, so that they can be compared across builds and releases.
+         */
+        void context();
+
+        /**
+         * Measures a benchmark reported in nanoseconds per operation.
+         * @param name The name of the benchmark
+         * @param body A body returning the number of operations it executed
+         */
+        void operations(const std::string& name, const Body& body);
+
+        /**
+         * Measures a benchmark reported in emulated millions of cycles per second.
+         * @param name The name of the benchmark
+         * @param body A body returning the number of cycles it emulated
+         */
+        void emulation(const std::string& name, const Body& body);
+
+        /**
+         * Measures a benchmark reported in emulated millions of cycles per second, preparing every call of its body
+         * out of the timing, such as to create a machine and load its program.
+         * @param name The name of the benchmark
+         * @param setup Prepares the next call of the body
+         * @param body A body returning the number of cycles it emulated
+         */
+        void emulation(const std::string& name, const Setup& setup, const Body& body);
+
+        /**
+         * Measures a benchmark reported in nanoseconds per operation, preparing every call of its body out of the
+         * timing.
+         * @param name The name of the benchmark
+         * @param setup Prepares the next call of the body
+         * @param body A body returning the number of operations it executed
+         */
+        void operations(const std::string& name, const Setup& setup, const Body& body);
+
+    private:
+        void measure(const std::string& name, const char* metric, bool perNanosecond, const Setup& setup,
+                     const Body& body);
+    };
+
+    void register_bus(Harness& harness);
+    void register_cpu(Harness& harness);
+    void register_dispatch(Harness& harness);
+    void register_workloads(Harness& harness);
+    void register_image(Harness& harness);
+}
+
+#endif
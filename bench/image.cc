@@ -0,0 +1,89 @@
+#include "harness.hh"
+
+#include "zasm/machine/image.hh"
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+namespace zasm::bench
+{
+    namespace
+    {
+        /**
+         * Creates an empty file of a unique name in the temporary directory, that the caller must remove.
+         */
+        std::string temporary()
+        {
+            auto pattern = (std::filesystem::temp_directory_path() / "zasm_bench_XXXXXX").string();
+
+#if defined(__unix__) || defined(__APPLE__)
+            auto descriptor = ::mkstemp(pattern.data());
+            if (descriptor < 0)
+            {
+                throw std::runtime_error("cannot create a temporary file");
+            }
+            ::close(descriptor);
+#else
+            std::random_device random;
+            pattern.replace(pattern.size() - 6, 6, std::to_string(random() % 1000000));
+#endif
+
+            return pattern;
+        }
+    }
+
+    void register_image(Harness& harness)
+    {
+        std::vector<byte_t> memory(ADDRESS_SPACE);
+        for (size_t i = 0; i < memory.size(); ++i)
+        {
+            memory[i] = byte_t(i * 7);
+        }
+
+        harness.operations("machine.start.copy", [memory](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                auto machine = std::make_unique<Machine>();
+                machine->bus().attach<RAM>(0x0000, ADDRESS_SPACE).write_span(0x0000, memory.data(), memory.size());
+                keep(machine->bus().read<byte_t>(address_t(i)));
+            }
+
+            return iterations;
+        });
+
+        harness.operations("machine.start.image", [memory](uint64_t iterations) {
+            // Saved on first use, which calibration keeps out of the measured repetitions.  The opened image no longer
+            // needs its file, which is removed right away.
+            static const auto image = [&memory]() {
+                auto path = temporary();
+
+                Machine machine;
+                machine.bus().attach<RAM>(0x0000, ADDRESS_SPACE).write_span(0x0000, memory.data(), memory.size());
+                Image::save(machine, path);
+
+                auto image = Image::open(path);
+                std::filesystem::remove(path);
+
+                return image;
+            }();
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                auto machine = std::make_unique<Machine>();
+                image.start(*machine);
+                keep(machine->bus().read<byte_t>(address_t(i)));
+            }
+
+            return iterations;
+        });
+    }
+}
@@ -0,0 +1,52 @@
+#include "harness.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    void usage(const char* program)
+    {
+        std::cerr << "usage: " << program << " [--filter NAME] [--repetitions N] [--target-ms N]\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    size_t repetitions = 9;
+    uint64_t milliseconds = 50;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+        {
+            repetitions = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--target-ms") == 0 && i + 1 < argc)
+        {
+            milliseconds = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    zasm::bench::Harness harness(std::cout, filter, repetitions, milliseconds * 1000000);
+    harness.context();
+
+    zasm::bench::register_bus(harness);
+    zasm::bench::register_cpu(harness);
+    zasm::bench::register_dispatch(harness);
+    zasm::bench::register_workloads(harness);
+    zasm::bench::register_image(harness);
+
+    return EXIT_SUCCESS;
+}
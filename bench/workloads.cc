@@ -0,0 +1,117 @@
+#include "harness.hh"
+
+#include "zasm/machine/machine.hh"
+
+#include <memory>
+
+namespace zasm::bench
+{
+    namespace
+    {
+        /**
+         * Registers a benchmark emulating a program loaded at address 0 of a machine with 64K of RAM.
+         * @param setup Prepares the machine once the program is loaded, such as to schedule device events
+         */
+        void emulate(Harness& harness, const std::string& workload, std::initializer_list<byte_t> program,
+                     void (*setup)(Machine&) = nullptr)
+        {
+            auto machine = std::make_shared<std::unique_ptr<Machine>>();
+
+            harness.emulation("workload." + workload, [machine, program, setup]() {
+                *machine = std::make_unique<Machine>();
+                (*machine)->bus().attach<RAM>(0x0000, ADDRESS_SPACE);
+                (*machine)->cpu().write(SP, 0xF000);
+                load((*machine)->bus(), 0x0000, program);
+
+                if (setup != nullptr)
+                {
+                    setup(**machine);
+                }
+            }, [machine](uint64_t iterations) {
+                return (*machine)->run(iterations);
+            });
+        }
+
+        /**
+         * Signals the guest every period, starting at the given cycle, as a timer would.
+         */
+        void tick(Machine& machine, uint64_t cycle, uint64_t period, void (*signal)(Machine&))
+        {
+            machine.scheduler().schedule(cycle, [&machine, cycle, period, signal]() {
+                signal(machine);
+                tick(machine, cycle + period, period, signal);
+            });
+        }
+    }
+
+    void register_workloads(Harness& harness)
+    {
+        // Copies 256 bytes at a time, one byte per iteration.
+        emulate(harness, "memcpy", {
+            0x21, 0x00, 0x40,   // 0000: ld hl, 0x4000
+            0x11, 0x00, 0x80,   // 0003: ld de, 0x8000
+            0x06, 0x00,         // 0006: ld b, 0
+            0x7E,               // 0008: ld a, (hl)
+            0x12,               // 0009: ld (de), a
+            0x23,               // 000A: inc hl
+            0x13,               // 000B: inc de
+            0x10, 0xFA,         // 000C: djnz 0x0008
+            0xC3, 0x00, 0x00,   // 000E: jp 0x0000
+        });
+
+        // Fills 256 bytes at a time with a constant.
+        emulate(harness, "memset", {
+            0x21, 0x00, 0x80,   // 0000: ld hl, 0x8000
+            0x06, 0x00,         // 0003: ld b, 0
+            0x36, 0xAA,         // 0005: ld (hl), 0xAA
+            0x23,               // 0007: inc hl
+            0x10, 0xFB,         // 0008: djnz 0x0005
+            0xC3, 0x00, 0x00,   // 000A: jp 0x0000
+        });
+
+        // Calls a leaf routine from a loop in another routine, stressing the stack.
+        emulate(harness, "calls", {
+            0x21, 0x00, 0x80,   // 0000: ld hl, 0x8000
+            0xCD, 0x09, 0x00,   // 0003: call 0x0009
+            0xC3, 0x03, 0x00,   // 0006: jp 0x0003
+            0x06, 0x08,         // 0009: ld b, 8
+            0xCD, 0x11, 0x00,   // 000B: call 0x0011
+            0x10, 0xFB,         // 000E: djnz 0x000B
+            0xC9,               // 0010: ret
+            0x7E,               // 0011: ld a, (hl)
+            0x77,               // 0012: ld (hl), a
+            0x23,               // 0013: inc hl
+            0xC9,               // 0014: ret
+        });
+
+        // Sleeps until a timer interrupt, like a mostly idle guest.
+        emulate(harness, "idle", {
+            0xFB,               // 0000: ei
+            0x76,               // 0001: halt
+            0x18, 0xFC,         // 0002: jr 0x0000
+        }, [](Machine& machine) {
+            load(machine.bus(), 0x0038, {
+                0xFB,           // 0038: ei
+                0xC9,           // 0039: ret
+            });
+
+            tick(machine, 10000, 10000, [](Machine& target) {
+                target.interrupt();
+            });
+        });
+
+        // Polls a device register until a timer sets it, then acknowledges it.
+        emulate(harness, "poll", {
+            0x3A, 0x00, 0x80,   // 0000: ld a, (0x8000)
+            0xE6, 0x01,         // 0003: and 1
+            0x28, 0xF9,         // 0005: jr z, 0x0000
+            0x21, 0x00, 0x80,   // 0007: ld hl, 0x8000
+            0x36, 0x00,         // 000A: ld (hl), 0
+            0x18, 0xF2,         // 000C: jr 0x0000
+        }, [](Machine& machine) {
+            tick(machine, 10000, 10000, [](Machine& target) {
+                target.bus().write(address_t(0x8000), byte_t(1));
+            });
+        });
+    }
+}
@@ -0,0 +1,283 @@
+#include "runner.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    using namespace zasm::conformance;
+
+    void usage(const char* program)
+    {
+        std::cerr << "usage: " << program << " [options] <file or directory>...\n"
+                  << "  --engine NAME    the engine to check (default: interpreter)\n"
+                  << "  --threads N      the number of threads (default: all cores)\n"
+                  << "  --ignore FIELDS  comma separated fields not to compare, such as r,f\n"
+                  << "  --no-cycles      do not compare cycles\n"
+                  << "  --strict         fail on opcodes that are not implemented\n"
+                  << "  --verbose        report every opcode, not only failing ones\n";
+    }
+
+    bool ignore(Options& options, const std::string& fields)
+    {
+        std::istringstream stream(fields);
+        std::string name;
+        while (std::getline(stream, name, ','))
+        {
+            auto found = false;
+            for (size_t field = 0; field < FIELD_COUNT; ++field)
+            {
+                if (name == field_name(Field(field)))
+                {
+                    options.ignored[field] = true;
+                    found = true;
+                }
+            }
+
+            if (!found)
+            {
+                std::cerr << "unknown field: " << name << '\n';
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * A part of a vector file that can be parsed on its own.
+     */
+    struct Segment
+    {
+        size_t file;
+        std::string_view text;
+    };
+
+    /**
+     * The approximate size of the segments in which files holding one vector per line are split.
+     */
+    constexpr size_t SEGMENT_SIZE = 1 << 20;
+
+    /**
+     * Splits a file in segments, at line boundaries when it holds one vector per line.
+     */
+    void split(size_t file, std::string_view text, std::vector<Segment>& segments)
+    {
+        auto first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string_view::npos)
+        {
+            return;
+        }
+
+        if (text[first] == '[')
+        {
+            segments.push_back({ file, text });
+            return;
+        }
+
+        while (!text.empty())
+        {
+            auto end = text.size() <= SEGMENT_SIZE ? std::string_view::npos : text.find('\n', SEGMENT_SIZE);
+            end = end == std::string_view::npos ? text.size() : end + 1;
+
+            segments.push_back({ file, text.substr(0, end) });
+            text.remove_prefix(end);
+        }
+    }
+
+    /**
+     * Expands directories into the vector files they hold, in a stable order.
+     */
+    std::vector<std::filesystem::path> files(const std::vector<std::string>& paths)
+    {
+        std::vector<std::filesystem::path> files;
+
+        for (const auto& path : paths)
+        {
+            if (!std::filesystem::is_directory(path))
+            {
+                files.emplace_back(path);
+                continue;
+            }
+
+            std::vector<std::filesystem::path> entries;
+            for (const auto& entry : std::filesystem::directory_iterator(path))
+            {
+                auto extension = entry.path().extension();
+                if (entry.is_regular_file() && (extension == ".json" || extension == ".jsonl"))
+                {
+                    entries.push_back(entry.path());
+                }
+            }
+
+            std::sort(entries.begin(), entries.end());
+            files.insert(files.end(), entries.begin(), entries.end());
+        }
+
+        return files;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::string engineName = "interpreter";
+    auto strict = false;
+    auto verbose = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--engine") == 0 && i + 1 < argc)
+        {
+            engineName = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            options.threads = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--ignore") == 0 && i + 1 < argc)
+        {
+            if (!ignore(options, argv[++i]))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--no-cycles") == 0)
+        {
+            options.cycles = false;
+        }
+        else if (std::strcmp(argv[i], "--strict") == 0)
+        {
+            strict = true;
+        }
+        else if (std::strcmp(argv[i], "--verbose") == 0)
+        {
+            verbose = true;
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            paths.emplace_back(argv[i]);
+        }
+    }
+
+    const auto& available = engines();
+    auto engine = std::find_if(available.begin(), available.end(), [&](const Engine& engine) {
+        return engineName == engine.name;
+    });
+
+    if (paths.empty() || engine == available.end())
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto inputs = files(paths);
+    std::vector<std::string> texts(inputs.size());
+    // Bytes rather than bits, since every thread sets its own.
+    std::vector<char> readable(inputs.size(), false);
+
+    parallel_for(inputs.size(), options.threads, 1, [&](size_t index, size_t) {
+        std::ifstream file(inputs[index], std::ios::binary);
+        std::error_code error;
+        auto size = std::filesystem::file_size(inputs[index], error);
+
+        if (file && !error)
+        {
+            texts[index].resize(size_t(size));
+            readable[index] = bool(file.read(texts[index].data(), std::streamsize(size)));
+        }
+    });
+
+    std::vector<Segment> segments;
+    for (size_t index = 0; index < inputs.size(); ++index)
+    {
+        if (!readable[index])
+        {
+            std::cerr << inputs[index].string() << ": cannot read file\n";
+            return EXIT_FAILURE;
+        }
+
+        split(index, texts[index], segments);
+    }
+
+    std::vector<std::vector<Vector>> parsed(segments.size());
+    std::vector<std::string> errors(segments.size());
+
+    parallel_for(segments.size(), options.threads, 1, [&](size_t index, size_t) {
+        try
+        {
+            parse(segments[index].text, parsed[index]);
+        }
+        catch (const ParseError& error)
+        {
+            errors[index] = error.what();
+        }
+    });
+
+    std::vector<Vector> vectors;
+    for (size_t index = 0; index < segments.size(); ++index)
+    {
+        if (!errors[index].empty())
+        {
+            std::cerr << inputs[segments[index].file].string() << ": " << errors[index] << '\n';
+            return EXIT_FAILURE;
+        }
+
+        std::move(parsed[index].begin(), parsed[index].end(), std::back_inserter(vectors));
+    }
+
+    auto reports = run(vectors, *engine, options);
+
+    uint64_t passed = 0;
+    uint64_t failed = 0;
+    uint64_t unimplemented = 0;
+    size_t failing = 0;
+
+    for (const auto& [key, report] : reports)
+    {
+        passed += report.passed;
+        failed += report.failed;
+        unimplemented += report.unimplemented;
+
+        if (report.first)
+        {
+            failing += 1;
+            std::cout << "FAIL " << key << "  passed " << report.passed << ", failed " << report.failed
+                      << "  first: " << report.first->vector << ": " << report.first->detail << '\n';
+        }
+        else if (verbose && report.unimplemented > 0)
+        {
+            std::cout << "SKIP " << key << "  not implemented\n";
+        }
+        else if (verbose)
+        {
+            std::cout << "PASS " << key << "  passed " << report.passed << '\n';
+        }
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << engine->name << ": " << vectors.size() << " vectors, " << passed << " passed, " << failed
+              << " failed, " << unimplemented << " not implemented, " << failing << " failing opcodes in "
+              << elapsed << "s\n";
+
+    return failed > 0 || (strict && unimplemented > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,250 @@
+#include "runner.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+namespace zasm::conformance
+{
+    namespace
+    {
+        /**
+         * The number of vectors a thread takes at once, to keep contention on the shared index low.
+         */
+        constexpr size_t CHUNK = 1024;
+
+        constexpr WordRegister WORD_FIELDS[] = { IX, IY, SP, PC, AF_, BC_, DE_, HL_ };
+
+        void write(Machine& machine, size_t field, int32_t value) noexcept
+        {
+            auto& cpu = machine.cpu();
+
+            if (field <= FIELD_R)
+            {
+                // Byte fields are declared in the same order as byte registers.
+                cpu.write(ByteRegister(field), byte_t(value));
+            }
+            else if (field <= FIELD_HL_)
+            {
+                cpu.write(WORD_FIELDS[field - FIELD_IX], word_t(value));
+            }
+            else if (field == FIELD_IFF1)
+            {
+                cpu.iff1() = value != 0;
+            }
+            else
+            {
+                cpu.iff2() = value != 0;
+            }
+        }
+
+        int32_t read(const Machine& machine, size_t field) noexcept
+        {
+            const auto& cpu = machine.cpu();
+
+            if (field <= FIELD_R)
+            {
+                return cpu.read(ByteRegister(field));
+            }
+            else if (field <= FIELD_HL_)
+            {
+                return cpu.read(WORD_FIELDS[field - FIELD_IX]);
+            }
+            else if (field == FIELD_IFF1)
+            {
+                return cpu.iff1() ? 1 : 0;
+            }
+            else
+            {
+                return cpu.iff2() ? 1 : 0;
+            }
+        }
+
+        std::string difference(const std::string& what, int64_t expected, int64_t actual)
+        {
+            char detail[96];
+            std::snprintf(detail, sizeof(detail), "%s: expected 0x%04llX, actual 0x%04llX", what.c_str(),
+                          (unsigned long long) expected, (unsigned long long) actual);
+            return detail;
+        }
+
+        std::string opcode(const Machine& machine)
+        {
+            auto pc = machine.cpu().read(PC);
+            auto byte = machine.bus().read<byte_t>(pc);
+
+            char key[8];
+            if (byte == 0xCB || byte == 0xDD || byte == 0xED || byte == 0xFD)
+            {
+                std::snprintf(key, sizeof(key), "%02X %02X", unsigned(byte), unsigned(machine.bus().read<byte_t>(pc + 1)));
+            }
+            else
+            {
+                std::snprintf(key, sizeof(key), "%02X", unsigned(byte));
+            }
+
+            return key;
+        }
+
+        /**
+         * Compares the state of a machine to the one expected by a vector, returning the first difference.
+         */
+        std::optional<std::string> compare(const Machine& machine, const Vector& vector, size_t cycles, const Options& options)
+        {
+            for (size_t field = 0; field < FIELD_COUNT; ++field)
+            {
+                auto expected = vector.final.fields[field];
+                if (expected < 0 || options.ignored[field])
+                {
+                    continue;
+                }
+
+                auto actual = read(machine, field);
+                if (actual != expected)
+                {
+                    return difference(field_name(Field(field)), expected, actual);
+                }
+            }
+
+            for (const auto& [address, expected] : vector.final.ram)
+            {
+                auto actual = machine.bus().read<byte_t>(address);
+                if (actual != expected)
+                {
+                    char what[16];
+                    std::snprintf(what, sizeof(what), "ram[0x%04X]", unsigned(address));
+                    return difference(what, expected, actual);
+                }
+            }
+
+            if (options.cycles && vector.cycles >= 0 && int64_t(cycles) != vector.cycles)
+            {
+                return difference("cycles", vector.cycles, int64_t(cycles));
+            }
+
+            return std::nullopt;
+        }
+
+        void merge(std::map<std::string, Report>& into, const std::map<std::string, Report>& from)
+        {
+            for (const auto& [key, report] : from)
+            {
+                auto& merged = into[key];
+                merged.passed += report.passed;
+                merged.failed += report.failed;
+                merged.unimplemented += report.unimplemented;
+
+                if (report.first && (!merged.first || report.first->index < merged.first->index))
+                {
+                    merged.first = report.first;
+                }
+            }
+        }
+    }
+
+    const std::vector<Engine>& engines()
+    {
+        static const std::vector<Engine> engines = {
+            { "interpreter", [](Machine& machine) { return machine.step(); } },
+        };
+
+        return engines;
+    }
+
+    void parallel_for(size_t count, size_t threads, size_t chunk,
+                      const std::function<void(size_t index, size_t thread)>& body)
+    {
+        chunk = std::max<size_t>(1, chunk);
+        threads = std::max<size_t>(1, std::min(threads, (count + chunk - 1) / chunk));
+
+        std::atomic<size_t> next(0);
+        auto worker = [&](size_t thread) {
+            for (auto start = next.fetch_add(chunk); start < count; start = next.fetch_add(chunk))
+            {
+                auto end = std::min(start + chunk, count);
+                for (auto index = start; index < end; ++index)
+                {
+                    body(index, thread);
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (size_t thread = 1; thread < threads; ++thread)
+        {
+            pool.emplace_back(worker, thread);
+        }
+
+        worker(0);
+
+        for (auto& thread : pool)
+        {
+            thread.join();
+        }
+    }
+
+    std::map<std::string, Report> run(const std::vector<Vector>& vectors, const Engine& engine, const Options& options)
+    {
+        auto threads = std::max<size_t>(1, options.threads);
+
+        std::vector<std::unique_ptr<Machine>> machines;
+        std::vector<std::map<std::string, Report>> reports(threads);
+        for (size_t thread = 0; thread < threads; ++thread)
+        {
+            machines.push_back(std::make_unique<Machine>());
+            machines.back()->bus().attach<RAM>(0x0000, ADDRESS_SPACE);
+            machines.back()->snapshot();
+        }
+
+        parallel_for(vectors.size(), threads, CHUNK, [&](size_t index, size_t thread) {
+            const auto& vector = vectors[index];
+            auto& machine = *machines[thread];
+
+            // Starts from a clean machine, so that the fields left unspecified by the vector, the halted state and
+            // the pending interrupts do not leak from the previous vector run by this thread.
+            machine.restore();
+
+            for (size_t field = 0; field < FIELD_COUNT; ++field)
+            {
+                if (vector.initial.fields[field] >= 0)
+                {
+                    write(machine, field, vector.initial.fields[field]);
+                }
+            }
+
+            for (const auto& [address, value] : vector.initial.ram)
+            {
+                machine.bus().write(address, value);
+            }
+
+            auto& report = reports[thread][opcode(machine)];
+
+            auto cycles = engine.step(machine);
+            if (cycles == 0)
+            {
+                report.unimplemented += 1;
+            }
+            else if (auto detail = compare(machine, vector, cycles, options))
+            {
+                report.failed += 1;
+                if (!report.first)
+                {
+                    report.first = Divergence { index, vector.name, std::move(*detail) };
+                }
+            }
+            else
+            {
+                report.passed += 1;
+            }
+        });
+
+        std::map<std::string, Report> merged;
+        for (const auto& report : reports)
+        {
+            merge(merged, report);
+        }
+
+        return merged;
+    }
+}
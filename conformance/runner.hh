@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef __ZASM__CONFORMANCE__RUNNER__
+#define __ZASM__CONFORMANCE__RUNNER__
+
+#include "vectors.hh"
+
+#include "zasm/machine/machine.hh"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace zasm::conformance
+{
+    /**
+     * A way of executing instructions on a machine.
+     */
+    struct Engine
+    {
+        const char* name;
+
+        /**
+         * Executes the instruction at PC, returning its cycles or 0 if it is not implemented.
+         */
+        std::function<size_t(Machine&)> step;
+    };
+
+    /**
+     * Gets every engine that can be checked against test vectors.
+     * @return The engines
+     */
+    [[nodiscard]] const std::vector<Engine>& engines();
+
+    /**
+     * The first difference found between the state of a machine and the one expected by a vector.
+     */
+    struct Divergence
+    {
+        size_t index;
+        std::string vector;
+        std::string detail;
+    };
+
+    /**
+     * The results of the vectors of a single opcode.
+     */
+    struct Report
+    {
+        uint64_t passed = 0;
+        uint64_t failed = 0;
+        uint64_t unimplemented = 0;
+
+        /**
+         * The divergence of the first failing vector, in the order vectors were given.
+         */
+        std::optional<Divergence> first;
+    };
+
+    struct Options
+    {
+        std::array<bool, FIELD_COUNT> ignored {};
+        bool cycles = true;
+        size_t threads = 1;
+    };
+
+    /**
+     * Calls a function for every index up to a count, spreading the calls over several threads.
+     * @param count The number of indices
+     * @param threads The number of threads to use, only as many being started as there are chunks
+     * @param chunk The number of consecutive indices a thread takes at once, at least 1
+     * @param body The function to call with an index and the number of the thread calling it
+     */
+    void parallel_for(size_t count, size_t threads, size_t chunk,
+                      const std::function<void(size_t index, size_t thread)>& body);
+
+    /**
+     * Runs test vectors against an engine, in parallel.
+     * @param vectors The vectors to run
+     * @param engine The engine executing the instructions
+     * @param options How to run the vectors
+     * @return The report of every opcode, keyed by the bytes identifying the opcode
+     */
+    [[nodiscard]] std::map<std::string, Report> run(const std::vector<Vector>& vectors, const Engine& engine, const Options& options);
+}
+
+#endif
@@ -0,0 +1,321 @@
+#include "vectors.hh"
+
+#include <cstring>
+#include <string_view>
+
+namespace zasm::conformance
+{
+    namespace
+    {
+        constexpr const char* FIELD_NAMES[FIELD_COUNT] = {
+            "a", "f", "b", "c", "d", "e", "h", "l", "i", "r",
+            "ix", "iy", "sp", "pc",
+            "af_", "bc_", "de_", "hl_",
+            "iff1", "iff2",
+        };
+
+        /**
+         * A recursive descent parser for the subset of JSON used by test vectors.
+         */
+        class Parser
+        {
+        private:
+            const char* _current;
+            const char* _end;
+
+        public:
+            Parser(std::string_view text)
+                : _current(text.data())
+                , _end(text.data() + text.size())
+            {
+            }
+
+            void vectors(std::vector<Vector>& vectors)
+            {
+                skip_whitespace();
+
+                if (_current == _end)
+                {
+                    return;
+                }
+
+                if (peek() != '[')
+                {
+                    while (_current != _end)
+                    {
+                        vectors.emplace_back();
+                        vector(vectors.back());
+                        skip_whitespace();
+                    }
+
+                    return;
+                }
+
+                expect('[');
+                skip_whitespace();
+                if (peek() == ']')
+                {
+                    ++_current;
+                    return;
+                }
+
+                do
+                {
+                    vectors.emplace_back();
+                    vector(vectors.back());
+                    skip_whitespace();
+                } while (accept(','));
+
+                expect(']');
+            }
+
+        private:
+            void vector(Vector& vector)
+            {
+                vector.cycles = -1;
+
+                object([&](std::string_view key) {
+                    if (key == "name")
+                    {
+                        string(vector.name);
+                    }
+                    else if (key == "initial")
+                    {
+                        state(vector.initial);
+                    }
+                    else if (key == "final")
+                    {
+                        state(vector.final);
+                    }
+                    else if (key == "cycles" && peek() != '[')
+                    {
+                        vector.cycles = integer();
+                    }
+                    else
+                    {
+                        skip_value();
+                    }
+                });
+            }
+
+            void state(State& state)
+            {
+                object([&](std::string_view key) {
+                    if (key == "ram")
+                    {
+                        ram(state.ram);
+                        return;
+                    }
+
+                    for (size_t field = 0; field < FIELD_COUNT; ++field)
+                    {
+                        if (key == FIELD_NAMES[field])
+                        {
+                            state.fields[field] = int32_t(integer());
+                            return;
+                        }
+                    }
+
+                    skip_value();
+                });
+            }
+
+            void ram(std::vector<std::pair<address_t, byte_t>>& ram)
+            {
+                array([&]() {
+                    expect('[');
+                    auto address = integer();
+                    skip_whitespace();
+                    expect(',');
+                    auto value = integer();
+                    skip_whitespace();
+                    expect(']');
+
+                    ram.emplace_back(address_t(address), byte_t(value));
+                });
+            }
+
+            template<typename F>
+            void object(F&& member)
+            {
+                skip_whitespace();
+                expect('{');
+                skip_whitespace();
+
+                if (accept('}'))
+                {
+                    return;
+                }
+
+                do
+                {
+                    skip_whitespace();
+                    auto key = view();
+                    skip_whitespace();
+                    expect(':');
+                    skip_whitespace();
+                    member(key);
+                    skip_whitespace();
+                } while (accept(','));
+
+                expect('}');
+            }
+
+            template<typename F>
+            void array(F&& element)
+            {
+                skip_whitespace();
+                expect('[');
+                skip_whitespace();
+
+                if (accept(']'))
+                {
+                    return;
+                }
+
+                do
+                {
+                    skip_whitespace();
+                    element();
+                    skip_whitespace();
+                } while (accept(','));
+
+                expect(']');
+            }
+
+            void string(std::string& string)
+            {
+                expect('"');
+
+                string.clear();
+                while (_current != _end && *_current != '"')
+                {
+                    if (*_current == '\\' && _current + 1 != _end)
+                    {
+                        ++_current;
+                    }
+
+                    string.push_back(*_current++);
+                }
+
+                expect('"');
+            }
+
+            /**
+             * Reads a string without unescaping it, which is enough for keys and ignored values.
+             */
+            std::string_view view()
+            {
+                expect('"');
+
+                auto start = _current;
+                while (_current != _end && *_current != '"')
+                {
+                    _current += *_current == '\\' && _current + 1 != _end ? 2 : 1;
+                }
+
+                auto view = std::string_view(start, size_t(_current - start));
+                expect('"');
+
+                return view;
+            }
+
+            int64_t integer()
+            {
+                skip_whitespace();
+
+                auto negative = accept('-');
+                if (_current == _end || *_current < '0' || *_current > '9')
+                {
+                    throw ParseError("expected an integer");
+                }
+
+                int64_t value = 0;
+                while (_current != _end && *_current >= '0' && *_current <= '9')
+                {
+                    value = value * 10 + (*_current++ - '0');
+                }
+
+                return negative ? -value : value;
+            }
+
+            void skip_value()
+            {
+                skip_whitespace();
+
+                switch (peek())
+                {
+                    case '{':
+                        object([&](std::string_view) { skip_value(); });
+                        break;
+                    case '[':
+                        array([&]() { skip_value(); });
+                        break;
+                    case '"':
+                        view();
+                        break;
+                    default:
+                        while (_current != _end && std::strchr(",]} \t\r\n", *_current) == nullptr)
+                        {
+                            ++_current;
+                        }
+                        break;
+                }
+            }
+
+            void skip_whitespace() noexcept
+            {
+                while (_current != _end && (*_current == ' ' || *_current == '\n' || *_current == '\r' || *_current == '\t'))
+                {
+                    ++_current;
+                }
+            }
+
+            [[nodiscard]] char peek() const
+            {
+                if (_current == _end)
+                {
+                    throw ParseError("unexpected end of file");
+                }
+
+                return *_current;
+            }
+
+            bool accept(char c) noexcept
+            {
+                if (_current != _end && *_current == c)
+                {
+                    ++_current;
+                    return true;
+                }
+
+                return false;
+            }
+
+            void expect(char c)
+            {
+                if (!accept(c))
+                {
+                    throw ParseError(std::string("expected '") + c + "'");
+                }
+            }
+        };
+    }
+
+    const char* field_name(Field field) noexcept
+    {
+        return FIELD_NAMES[field];
+    }
+
+    State::State()
+        : fields()
+        , ram()
+    {
+        fields.fill(-1);
+    }
+
+    void parse(std::string_view text, std::vector<Vector>& vectors)
+    {
+        Parser(text).vectors(vectors);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#ifndef __ZASM__CONFORMANCE__VECTORS__
+#define __ZASM__CONFORMANCE__VECTORS__
+
+#include "zasm/types.hh"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace zasm::conformance
+{
+    /**
+     * The fields of a CPU state that a test vector can specify.
+     */
+    enum Field
+    {
+        FIELD_A, FIELD_F, FIELD_B, FIELD_C, FIELD_D, FIELD_E, FIELD_H, FIELD_L, FIELD_I, FIELD_R,
+        FIELD_IX, FIELD_IY, FIELD_SP, FIELD_PC,
+        FIELD_AF_, FIELD_BC_, FIELD_DE_, FIELD_HL_,
+        FIELD_IFF1, FIELD_IFF2,
+        FIELD_COUNT,
+    };
+
+    /**
+     * Gets the name of a field, as used in test vector files.
+     * @param field A field
+     * @return Its name
+     */
+    [[nodiscard]] const char* field_name(Field field) noexcept;
+
+    /**
+     * The state of a CPU and of the memory it reaches, as specified by a test vector.
+     */
+    struct State
+    {
+        /**
+         * The value of every field, or -1 if the field is not specified.
+         */
+        std::array<int32_t, FIELD_COUNT> fields;
+
+        std::vector<std::pair<address_t, byte_t>> ram;
+
+        State();
+    };
+
+    /**
+     * A test vector, giving the expected state after executing a single instruction from an initial state.
+     */
+    struct Vector
+    {
+        std::string name;
+        State initial;
+        State final;
+
+        /**
+         * The expected number of cycles, or -1 if not specified in the units of the core.
+         */
+        int64_t cycles;
+    };
+
+    /**
+     * An error in the syntax of a test vector file.
+     */
+    class ParseError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * Parses the test vectors of a file.
+     *
+     * The file either holds one JSON object per line, or a JSON array of objects, in the format of the
+     * SingleStepTests suites: `name`, `initial` and `final` objects holding registers and a `ram` array of
+     * `[address, value]` pairs.  The `cycles` of a vector are only checked when given as an integer, the bus traces
+     * of those suites counting T-states rather than the cycles returned by the core.
+     * @param text The content of the file, or a sequence of its lines when it holds one object per line
+     * @param vectors The vectors to which parsed vectors are appended
+     * @throws ParseError If the file is malformed
+     */
+    void parse(std::string_view text, std::vector<Vector>& vectors);
+}
+
+#endif
@@ -0,0 +1,287 @@
+#include "fuzzer.hh"
+
+#include "zasm/machine/input.hh"
+#include "zasm/machine/machine.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <thread>
+
+namespace zasm::fuzz
+{
+    namespace
+    {
+        /**
+         * The number of executions between two refreshes of the corpus of a thread, which is also when it publishes
+         * its number of executions.
+         */
+        constexpr uint64_t REFRESH = 1024;
+
+        constexpr byte_t INTERESTING[] = { 0x00, 0x01, 0x7F, 0x80, 0xFE, 0xFF };
+
+        class Mutator
+        {
+        private:
+            std::mt19937_64 _random;
+            size_t _maxLength;
+
+        public:
+            Mutator(uint64_t seed, size_t maxLength)
+                : _random(seed)
+                , _maxLength(std::max<size_t>(maxLength, 1))
+            {
+            }
+
+            void mutate(Input& input, const std::vector<Input>& corpus)
+            {
+                auto count = 1 + below(4);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    once(input, corpus);
+                }
+
+                if (input.size() > _maxLength)
+                {
+                    input.resize(_maxLength);
+                }
+            }
+
+            size_t below(size_t bound)
+            {
+                return bound == 0 ? 0 : size_t(_random() % bound);
+            }
+
+        private:
+            void once(Input& input, const std::vector<Input>& corpus)
+            {
+                if (input.empty())
+                {
+                    input.push_back(byte_t(_random()));
+                    return;
+                }
+
+                auto position = below(input.size());
+
+                switch (below(7))
+                {
+                    case 0:
+                        input[position] ^= byte_t(1u << below(8));
+                        break;
+                    case 1:
+                        input[position] = byte_t(_random());
+                        break;
+                    case 2:
+                        input[position] = INTERESTING[below(sizeof(INTERESTING))];
+                        break;
+                    case 3:
+                        input[position] = byte_t(input[position] + 1 + below(16) - 8);
+                        break;
+                    case 4:
+                        input.insert(input.begin() + std::ptrdiff_t(position), byte_t(_random()));
+                        break;
+                    case 5:
+                        if (input.size() > 1)
+                        {
+                            input.erase(input.begin() + std::ptrdiff_t(position));
+                        }
+                        break;
+                    default:
+                    {
+                        // Splices the tail of another input of the corpus.
+                        const auto& other = corpus[below(corpus.size())];
+                        if (!other.empty())
+                        {
+                            auto from = below(other.size());
+                            input.resize(position);
+                            input.insert(input.end(), other.begin() + std::ptrdiff_t(from), other.end());
+                        }
+                        break;
+                    }
+                }
+            }
+        };
+    }
+
+    Fuzzer::Fuzzer(Options options)
+        : _options(std::move(options))
+        , _bitmap(new std::atomic<byte_t>[Coverage::DEFAULT_SIZE])
+        , _mutex()
+        , _corpus()
+        , _stops()
+        , _executions(0)
+        , _stopping(false)
+    {
+        for (size_t i = 0; i < Coverage::DEFAULT_SIZE; ++i)
+        {
+            _bitmap[i].store(0, std::memory_order_relaxed);
+        }
+
+        if (_options.corpus && std::filesystem::is_directory(*_options.corpus))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(*_options.corpus))
+            {
+                if (!entry.is_regular_file())
+                {
+                    continue;
+                }
+
+                std::ifstream file(entry.path(), std::ios::binary);
+                _corpus.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+        }
+
+        if (_corpus.empty())
+        {
+            _corpus.emplace_back(1, byte_t(0));
+        }
+    }
+
+    void Fuzzer::run()
+    {
+        std::vector<std::thread> threads;
+        for (size_t thread = 1; thread < std::max<size_t>(_options.threads, 1); ++thread)
+        {
+            threads.emplace_back(&Fuzzer::work, this, thread);
+        }
+
+        work(0);
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    void Fuzzer::stop() noexcept
+    {
+        _stopping.store(true, std::memory_order_relaxed);
+    }
+
+    uint64_t Fuzzer::executions() const noexcept
+    {
+        return _executions.load(std::memory_order_relaxed);
+    }
+
+    size_t Fuzzer::edges() const noexcept
+    {
+        size_t edges = 0;
+        for (size_t i = 0; i < Coverage::DEFAULT_SIZE; ++i)
+        {
+            edges += _bitmap[i].load(std::memory_order_relaxed) != 0 ? 1 : 0;
+        }
+
+        return edges;
+    }
+
+    size_t Fuzzer::corpus()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _corpus.size();
+    }
+
+    size_t Fuzzer::stops()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stops.size();
+    }
+
+    void Fuzzer::work(size_t thread)
+    {
+        Machine machine;
+        auto& bus = machine.bus();
+
+        bus.attach<RAM>(0x0000, _options.input);
+        auto& device = bus.attach<InputDevice>(_options.input);
+        bus.attach<RAM>(address_t(_options.input + 2), ADDRESS_SPACE);
+
+        bus.write_span(_options.load, _options.firmware.data(), _options.firmware.size());
+
+        machine.cpu().write(PC, _options.entry);
+        machine.cpu().write(SP, _options.stack);
+        machine.snapshot();
+
+        Coverage coverage;
+        machine.attach(&coverage);
+
+        Mutator mutator(_options.seed + thread, _options.maxLength);
+        std::vector<Input> corpus;
+        Input input;
+
+        uint64_t execution = 0;
+        uint64_t published = 0;
+        for (; !_stopping.load(std::memory_order_relaxed); ++execution)
+        {
+            if (execution % REFRESH == 0)
+            {
+                // Counting every execution on the shared counter would bounce its cache line between threads.
+                _executions.fetch_add(execution - published, std::memory_order_relaxed);
+                published = execution;
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                corpus = _corpus;
+            }
+
+            // Replays the corpus once before mutating it, so that its coverage is known.
+            if (thread == 0 && execution < corpus.size())
+            {
+                input = corpus[execution];
+            }
+            else
+            {
+                input = corpus[mutator.below(corpus.size())];
+                mutator.mutate(input, corpus);
+            }
+
+            machine.restore();
+            device.feed(input.data(), input.size());
+
+            auto executed = machine.run(_options.cycles);
+
+            if (executed < _options.cycles)
+            {
+                auto pc = machine.cpu().read(PC);
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_stops.insert(pc).second)
+                {
+                    keep(input, "stop");
+                }
+            }
+
+            if (coverage.merge(_bitmap.get()))
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _corpus.push_back(input);
+                keep(input, "input");
+            }
+        }
+
+        _executions.fetch_add(execution - published, std::memory_order_relaxed);
+    }
+
+    void Fuzzer::keep(const Input& input, const char* kind)
+    {
+        if (!_options.corpus)
+        {
+            return;
+        }
+
+        // New inputs go next to the initial ones, so that later sessions start from them.
+        auto directory = std::string(kind) == "stop" ? *_options.corpus / "stops" : *_options.corpus;
+        std::filesystem::create_directories(directory);
+
+        uint64_t hash = 0xCBF29CE484222325u;
+        for (auto byte : input)
+        {
+            hash = (hash ^ byte) * 0x100000001B3u;
+        }
+
+        char name[40];
+        std::snprintf(name, sizeof(name), "%s-%016llx", kind, (unsigned long long) hash);
+
+        std::ofstream file(directory / name, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(input.data()), std::streamsize(input.size()));
+    }
+}
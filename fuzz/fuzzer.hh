@@ -0,0 +1,101 @@
+#pragma once
+
+#ifndef __ZASM__FUZZ__FUZZER__
+#define __ZASM__FUZZ__FUZZER__
+
+#include "zasm/machine/coverage.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace zasm::fuzz
+{
+    using Input = std::vector<byte_t>;
+
+    struct Options
+    {
+        Input firmware;
+        address_t load = 0x0000;
+        address_t entry = 0x0000;
+        address_t stack = 0xFF00;
+        address_t input = 0xFF00;
+
+        uint64_t cycles = 100000;
+        size_t maxLength = 1024;
+        size_t threads = 1;
+        uint64_t seed = 0;
+
+        /**
+         * The directory holding the initial inputs, to which new inputs are written, and findings to its `stops`
+         * subdirectory.
+         */
+        std::optional<std::filesystem::path> corpus;
+    };
+
+    /**
+     * A coverage-guided fuzzer running a firmware on one machine per thread.
+     *
+     * Every thread prepares its machine once, takes a snapshot of it, and then restores it before every execution.
+     * Inputs are fed to the guest through an `InputDevice`, and inputs reaching new coverage of the shared bitmap are
+     * added to the corpus.  Executions stopping before their cycle budget, on an instruction the core does not
+     * implement, are kept as findings, once per address.
+     *
+     * Restoring a machine leaves its scheduler and cycle counter untouched, which keeps executions deterministic as
+     * long as nothing schedules events, as is the case for the machines of the fuzzer.
+     */
+    class Fuzzer final
+    {
+    private:
+        Options _options;
+
+        std::unique_ptr<std::atomic<byte_t>[]> _bitmap;
+
+        std::mutex _mutex;
+        std::vector<Input> _corpus;
+        std::set<address_t> _stops;
+
+        std::atomic<uint64_t> _executions;
+        std::atomic<bool> _stopping;
+
+    public:
+        explicit Fuzzer(Options options);
+
+        /**
+         * Runs the fuzzer on every thread until `stop` is called.
+         */
+        void run();
+
+        /**
+         * Asks every thread to stop after its current execution.
+         */
+        void stop() noexcept;
+
+        /**
+         * Gets the number of executions, which threads publish in batches while running and in full once stopped.
+         */
+        [[nodiscard]] uint64_t executions() const noexcept;
+
+        /**
+         * Gets the number of entries set in the shared bitmap.
+         */
+        [[nodiscard]] size_t edges() const noexcept;
+
+        [[nodiscard]] size_t corpus();
+
+        [[nodiscard]] size_t stops();
+
+    private:
+        void work(size_t thread);
+
+        void keep(const Input& input, const char* kind);
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "fuzzer.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+
+namespace
+{
+    void usage(const char* program)
+    {
+        std::cerr << "usage: " << program << " [options] <firmware>\n"
+                  << "  --load ADDRESS     where the firmware is loaded (default: 0x0000)\n"
+                  << "  --entry ADDRESS    where execution starts (default: the load address)\n"
+                  << "  --stack ADDRESS    the initial stack pointer (default: 0xFF00)\n"
+                  << "  --input ADDRESS    the address of the input device (default: 0xFF00)\n"
+                  << "  --cycles N         the cycle budget of an execution (default: 100000)\n"
+                  << "  --max-length N     the maximum length of an input (default: 1024)\n"
+                  << "  --corpus DIRECTORY the initial inputs, where new inputs are written\n"
+                  << "  --threads N        the number of threads (default: all cores)\n"
+                  << "  --seconds N        how long to fuzz (default: 10)\n"
+                  << "  --seed N           the seed of the mutations (default: 0)\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    zasm::fuzz::Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto entry = false;
+    uint64_t seconds = 10;
+    const char* firmware = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto option = [&](const char* name) {
+            return std::strcmp(argv[i], name) == 0 && i + 1 < argc;
+        };
+
+        if (option("--load"))
+        {
+            options.load = zasm::address_t(std::strtoul(argv[++i], nullptr, 0));
+        }
+        else if (option("--entry"))
+        {
+            options.entry = zasm::address_t(std::strtoul(argv[++i], nullptr, 0));
+            entry = true;
+        }
+        else if (option("--stack"))
+        {
+            options.stack = zasm::address_t(std::strtoul(argv[++i], nullptr, 0));
+        }
+        else if (option("--input"))
+        {
+            options.input = zasm::address_t(std::strtoul(argv[++i], nullptr, 0));
+        }
+        else if (option("--cycles"))
+        {
+            options.cycles = std::strtoull(argv[++i], nullptr, 0);
+        }
+        else if (option("--max-length"))
+        {
+            options.maxLength = std::strtoul(argv[++i], nullptr, 0);
+        }
+        else if (option("--corpus"))
+        {
+            options.corpus = argv[++i];
+        }
+        else if (option("--threads"))
+        {
+            options.threads = std::strtoul(argv[++i], nullptr, 0);
+        }
+        else if (option("--seconds"))
+        {
+            seconds = std::strtoull(argv[++i], nullptr, 0);
+        }
+        else if (option("--seed"))
+        {
+            options.seed = std::strtoull(argv[++i], nullptr, 0);
+        }
+        else if (argv[i][0] != '-' && firmware == nullptr)
+        {
+            firmware = argv[i];
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (firmware == nullptr)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(firmware, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << firmware << ": cannot open file\n";
+        return EXIT_FAILURE;
+    }
+
+    options.firmware.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (!entry)
+    {
+        options.entry = options.load;
+    }
+
+    zasm::fuzz::Fuzzer fuzzer(std::move(options));
+    std::thread runner([&fuzzer]() { fuzzer.run(); });
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t second = 1; second <= seconds; ++second)
+    {
+        std::this_thread::sleep_until(start + std::chrono::seconds(second));
+
+        std::cerr << "[" << second << "s] executions " << fuzzer.executions()
+                  << ", " << fuzzer.executions() / second << "/s"
+                  << ", edges " << fuzzer.edges()
+                  << ", corpus " << fuzzer.corpus()
+                  << ", stops " << fuzzer.stops() << '\n';
+    }
+
+    fuzzer.stop();
+    runner.join();
+
+    return EXIT_SUCCESS;
+}
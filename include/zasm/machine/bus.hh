@@ -4,9 +4,11 @@
 #define __ZASM__MACHINE__BUS__
 
 #include "zasm/types.hh"
+#include "zasm/machine/metrics.hh"
 
 #include <vector>
 #include <memory>
+#include <utility>
 
 namespace zasm
 {
@@ -49,6 +51,59 @@ namespace zasm
          * @return If the address is writable
          */
         [[nodiscard]] virtual bool accept_write(address_t address) const noexcept;
+
+        /**
+         * Indicates if reading at the given address has no side effect and keeps returning the same byte, as long as
+         * the address is not written to and no scheduled event runs.
+         *
+         * By default, reads are assumed to have side effects.
+         * @param address An address
+         * @return If reads at the address are idempotent
+         */
+        [[nodiscard]] virtual bool idempotent(address_t address) const noexcept;
+
+        /**
+         * Gets the number of consecutive addresses, starting at the given one, over which this bus component keeps
+         * accepting or keeps rejecting reads and writes.
+         *
+         * By default, bus components may change at every address and this returns 1, so that bulk accesses fall back
+         * to accessing a single byte at a time.
+         * @param address An address
+         * @return The number of addresses, at least 1
+         */
+        [[nodiscard]] virtual size_t extent(address_t address) const noexcept;
+
+        /**
+         * Reads consecutive bytes from this bus component, which accepts reads on the whole range.
+         *
+         * By default, bytes are read one at a time.
+         * @param address The address of the first byte
+         * @param bytes Where to store the read bytes
+         * @param size The number of bytes to read, not going past the end of the address space
+         */
+        virtual void read_span(address_t address, byte_t* bytes, size_t size) const noexcept;
+
+        /**
+         * Writes consecutive bytes to this bus component, which accepts writes on the whole range.
+         *
+         * By default, bytes are written one at a time.
+         * @param address The address of the first byte
+         * @param bytes The bytes to write
+         * @param size The number of bytes to write, not going past the end of the address space
+         */
+        virtual void write_span(address_t address, const byte_t* bytes, size_t size) noexcept;
+
+        /**
+         * Remembers the current state of this bus component, so that it can be restored later on.
+         *
+         * By default, bus components are stateless and this does nothing.
+         */
+        virtual void snapshot();
+
+        /**
+         * Restores the state of this bus component to the one of its last snapshot.
+         */
+        virtual void restore() noexcept;
     };
 
     /**
@@ -58,6 +113,7 @@ namespace zasm
     {
     private:
         std::vector<std::unique_ptr<BusComponent>> _components;
+        mutable std::vector<ComponentMetrics> _metrics;
 
     public:
         /**
@@ -76,6 +132,58 @@ namespace zasm
         Bus(Bus&&) = default;
         Bus& operator=(Bus&&) = default;
 
+        /**
+         * Attaches a component to this bus, giving it ownership of the component.
+         * @param component The component to attach
+         * @return A reference to the attached component
+         */
+        BusComponent& attach(std::unique_ptr<BusComponent> component);
+
+        /**
+         * Constructs a component in place and attaches it to this bus.
+         * @tparam T The type of component
+         * @param args The arguments forwarded to the component's constructor
+         * @return A reference to the attached component
+         */
+        template<typename T, typename... Args>
+        T& attach(Args&&... args)
+        {
+            auto component = std::make_unique<T>(std::forward<Args>(args)...);
+            auto& reference = *component;
+            attach(std::move(component));
+            return reference;
+        }
+
+        /**
+         * Gets the attached components, in the order they were attached.
+         */
+        [[nodiscard]] inline const std::vector<std::unique_ptr<BusComponent>>& components() const noexcept
+        {
+            return _components;
+        }
+
+        /**
+         * Remembers the current state of every attached component.
+         */
+        void snapshot();
+
+        /**
+         * Restores every attached component to the state of its last snapshot.
+         */
+        void restore() noexcept;
+
+        /**
+         * Gets the number of accesses made to each attached component, in the order they were attached.
+         *
+         * Every read and write made through the bus is counted: the accesses of instructions, opcode fetches included,
+         * those of components such as the DMA controller, and those of the host.  Only peeks are left out.
+         * @return The counters of every component
+         */
+        [[nodiscard]] inline const std::vector<ComponentMetrics>& metrics() const noexcept
+        {
+            return _metrics;
+        }
+
         /**
          * Reads a single value of the given type from the bus.
          * @tparam T The type to read
@@ -85,17 +193,52 @@ namespace zasm
         template<typename T>
         [[nodiscard]] T read(address_t address) const noexcept = delete;
 
-        template<>
-        [[nodiscard]] inline byte_t read<byte_t>(address_t address) const noexcept
-        {
-            return read_byte(address);
-        }
+        /**
+         * Indicates if reading at the given address has no side effect on any of the components accepting the read.
+         * @param address An address
+         * @return If reads at the address are idempotent
+         */
+        [[nodiscard]] bool idempotent(address_t address) const noexcept;
 
-        template<>
-        [[nodiscard]] inline word_t read<word_t>(address_t address) const noexcept
-        {
-            return read_word(address);
-        }
+        /**
+         * Reads consecutive bytes from the bus, wrapping around the end of the address space.
+         *
+         * The range is split wherever a component starts or stops accepting reads, and every component accepting a
+         * part of the range is asked for all of it in a single bulk read.
+         * @param address The address of the first byte
+         * @param bytes Where to store the read bytes
+         * @param size The number of bytes to read
+         */
+        void read_span(address_t address, byte_t* bytes, size_t size) const noexcept;
+
+        /**
+         * Reads a single byte from the bus without counting it in the metrics, for the host inspecting the bus rather
+         * than the program accessing it.
+         *
+         * The read still reaches the components, so only idempotent addresses should be peeked at.
+         * @param address The address at which to read the byte
+         * @return The byte that was read
+         */
+        [[nodiscard]] byte_t peek(address_t address) const noexcept;
+
+        /**
+         * Reads consecutive bytes as `read_span` does, without counting them in the metrics.
+         * @param address The address of the first byte
+         * @param bytes Where to store the read bytes
+         * @param size The number of bytes to read
+         */
+        void peek_span(address_t address, byte_t* bytes, size_t size) const noexcept;
+
+        /**
+         * Writes consecutive bytes to the bus, wrapping around the end of the address space.
+         *
+         * The range is split wherever a component starts or stops accepting writes, and every component accepting a
+         * part of the range is given all of it in a single bulk write.
+         * @param address The address of the first byte
+         * @param bytes The bytes to write
+         * @param size The number of bytes to write
+         */
+        void write_span(address_t address, const byte_t* bytes, size_t size) noexcept;
 
         /**
          * Writes a single byte to the bus.
@@ -113,26 +256,83 @@ namespace zasm
 
     private:
         [[nodiscard]] byte_t read_byte(address_t address) const noexcept;
+
+        void read_span(address_t address, byte_t* bytes, size_t size, bool counted) const noexcept;
         [[nodiscard]] word_t read_word(address_t address) const noexcept;
+
+        /**
+         * Gets the number of bytes from the given address over which no component changes.
+         */
+        [[nodiscard]] size_t chunk(address_t address, size_t size) const noexcept;
     };
 
+    template<>
+    [[nodiscard]] inline byte_t Bus::read<byte_t>(address_t address) const noexcept
+    {
+        return read_byte(address);
+    }
+
+    template<>
+    [[nodiscard]] inline word_t Bus::read<word_t>(address_t address) const noexcept
+    {
+        return read_word(address);
+    }
+
     /**
      * A bus component holding memory that can be read and written to.
+     *
+     * Writes mark the pages they touch as dirty, so that restoring a snapshot only copies the pages written since.
      */
     class RAM : public BusComponent
     {
     private:
         address_t _inclusiveStart;
-        address_t _exclusiveEnd;
-        std::vector<byte_t> _memory;
+        size_t _exclusiveEnd;
+        std::shared_ptr<byte_t> _storage;
+        byte_t* _memory;
+
+        std::vector<byte_t> _snapshot;
+        std::vector<bool> _dirty;
+        std::vector<size_t> _dirtyPages;
 
     public:
+        /**
+         * The number of bytes in a page tracked for snapshots.
+         */
+        static constexpr size_t PAGE_SIZE = 256;
+
         /**
          * Creates a new RAM component for the given address ranges.
          * @param inclusiveStart The inclusive starting address
-         * @param exclusiveEnd The exclusive ending address
+         * @param exclusiveEnd The exclusive ending address, up to `ADDRESS_SPACE`
          */
-        RAM(address_t inclusiveStart, address_t exclusiveEnd);
+        RAM(address_t inclusiveStart, size_t exclusiveEnd);
+
+        /**
+         * Creates a new RAM component over existing memory, such as a section mapped from a machine image.
+         * @param inclusiveStart The inclusive starting address
+         * @param exclusiveEnd The exclusive ending address, up to `ADDRESS_SPACE`
+         * @param memory At least `exclusiveEnd - inclusiveStart` bytes, released along with the component
+         */
+        RAM(address_t inclusiveStart, size_t exclusiveEnd, std::shared_ptr<byte_t> memory);
+
+        [[nodiscard]] inline address_t start() const noexcept
+        {
+            return _inclusiveStart;
+        }
+
+        [[nodiscard]] inline size_t end() const noexcept
+        {
+            return _exclusiveEnd;
+        }
+
+        /**
+         * Gets the bytes held by this component, starting with the one at its starting address.
+         */
+        [[nodiscard]] inline const byte_t* data() const noexcept
+        {
+            return _memory;
+        }
 
         [[nodiscard]] byte_t read(address_t address) const noexcept override;
 
@@ -141,6 +341,18 @@ namespace zasm
         [[nodiscard]] bool accept_read(address_t address) const noexcept override;
 
         [[nodiscard]] bool accept_write(address_t address) const noexcept override;
+
+        [[nodiscard]] bool idempotent(address_t address) const noexcept override;
+
+        [[nodiscard]] size_t extent(address_t address) const noexcept override;
+
+        void read_span(address_t address, byte_t* bytes, size_t size) const noexcept override;
+
+        void write_span(address_t address, const byte_t* bytes, size_t size) noexcept override;
+
+        void snapshot() override;
+
+        void restore() noexcept override;
     };
 
     /**
@@ -152,9 +364,17 @@ namespace zasm
         /**
          * Creates a new ROM component for the given address range.
          * @param inclusiveStart The inclusive starting address
-         * @param exclusiveEnd The exclusive ending address
+         * @param exclusiveEnd The exclusive ending address, up to `ADDRESS_SPACE`
+         */
+        ROM(address_t inclusiveStart, size_t exclusiveEnd);
+
+        /**
+         * Creates a new ROM component over existing memory, such as a section mapped from a machine image.
+         * @param inclusiveStart The inclusive starting address
+         * @param exclusiveEnd The exclusive ending address, up to `ADDRESS_SPACE`
+         * @param memory At least `exclusiveEnd - inclusiveStart` bytes, released along with the component
          */
-        ROM(address_t inclusiveStart, address_t exclusiveEnd);
+        ROM(address_t inclusiveStart, size_t exclusiveEnd, std::shared_ptr<byte_t> memory);
 
         [[nodiscard]] bool accept_write(address_t address) const noexcept override;
     };
@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__COMPILED__
+#define __ZASM__MACHINE__COMPILED__
+
+#include "zasm/types.hh"
+#include "zasm/machine/bus.hh"
+#include "zasm/machine/cpu.hh"
+#include "zasm/machine/scheduler.hh"
+
+#include <cstdint>
+
+namespace zasm
+{
+    /**
+     * The state shared between a machine and the recompiled code it runs.
+     *
+     * Recompiled code stops at the first instruction boundary where the machine would do anything else than execute
+     * the next instruction: once it reaches the end of its run or the next scheduled event, or when it could accept an
+     * interrupt.
+     */
+    struct CompiledContext
+    {
+        CPU& cpu;
+        Bus& bus;
+        const Scheduler& scheduler;
+        const bool& interrupt;
+
+        uint64_t start;
+        uint64_t until;
+
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+
+        /**
+         * Indicates if the last instruction executed delays interrupts, as is the case for `EI`.
+         */
+        bool deferred = false;
+
+        /**
+         * Accounts for the opcode fetches of an instruction, before it executes.
+         * @param fetches The number of opcode fetches of the instruction
+         */
+        inline void fetch(byte_t fetches) noexcept
+        {
+            cpu.refresh(fetches);
+        }
+
+        /**
+         * Accounts for an executed instruction.
+         * @param taken The number of cycles taken by the instruction
+         */
+        inline void retire(size_t taken) noexcept
+        {
+            cycles += taken;
+            instructions += 1;
+        }
+
+        /**
+         * Indicates if recompiled code must return to the machine before executing the next instruction.
+         */
+        [[nodiscard]] inline bool exhausted() const noexcept
+        {
+            auto now = start + cycles;
+            return now >= until || now >= scheduler.next() || (interrupt && cpu.iff1());
+        }
+    };
+
+    /**
+     * Firmware recompiled ahead of time to C++ by `zasm_aot`.
+     *
+     * The firmware must be held by a ROM component, at the same address and with the same content as when it was
+     * recompiled.
+     */
+    struct CompiledCode
+    {
+        /**
+         * The address of the first byte of the firmware.
+         */
+        address_t start;
+
+        /**
+         * The exclusive ending address of the firmware.
+         */
+        size_t end;
+
+        /**
+         * The FNV-1a hash of the firmware.
+         */
+        uint64_t checksum;
+
+        /**
+         * Executes recompiled instructions from PC, returning as soon as PC leaves the recompiled code or the context
+         * is exhausted.
+         */
+        void (*run)(CompiledContext& context);
+
+        /**
+         * Hashes firmware as done for `checksum`.
+         */
+        [[nodiscard]] static uint64_t hash(const byte_t* bytes, size_t size) noexcept;
+
+        /**
+         * Indicates if a bus holds the firmware this code was recompiled from.
+         */
+        [[nodiscard]] bool matches(const Bus& bus) const;
+    };
+}
+
+#endif
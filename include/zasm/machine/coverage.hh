@@ -0,0 +1,101 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__COVERAGE__
+#define __ZASM__MACHINE__COVERAGE__
+
+#include "zasm/types.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace zasm
+{
+    /**
+     * Edge coverage of the branches taken by a machine.
+     *
+     * Edges are hashed into a table of hit counters, in the fashion of AFL.  After every execution, the edges that were
+     * hit are merged into a bitmap that can be shared by every machine of every thread, each byte of that bitmap
+     * holding one bit per class of hit counts, and the counters are cleared in time proportional to the number of
+     * edges that were hit.
+     */
+    class Coverage final
+    {
+    private:
+        std::vector<byte_t> _hits;
+        std::vector<uint32_t> _touched;
+        size_t _mask;
+
+    public:
+        /**
+         * The default number of entries of the coverage tables.
+         */
+        static constexpr size_t DEFAULT_SIZE = 1 << 16;
+
+        /**
+         * Creates a new coverage table.
+         * @param size The number of entries of the table, rounded up to a power of two
+         */
+        explicit Coverage(size_t size = DEFAULT_SIZE);
+
+        /**
+         * Gets the number of entries of the table, and of the shared bitmap it is merged into.
+         * @return The number of entries
+         */
+        [[nodiscard]] inline size_t size() const noexcept
+        {
+            return _hits.size();
+        }
+
+        /**
+         * Records a transfer of control between two addresses.
+         * @param from The address of the branching instruction
+         * @param to The address where execution continues
+         */
+        inline void edge(address_t from, address_t to) noexcept
+        {
+            auto index = (hash(from) ^ (hash(to) >> 1u)) & _mask;
+
+            auto& hits = _hits[index];
+            if (hits == 0)
+            {
+                _touched.push_back(uint32_t(index));
+            }
+
+            if (hits != 0xFF)
+            {
+                hits += 1;
+            }
+        }
+
+        /**
+         * Gets the number of distinct edges hit since the last merge.
+         * @return The number of edges
+         */
+        [[nodiscard]] inline size_t edges() const noexcept
+        {
+            return _touched.size();
+        }
+
+        /**
+         * Merges the edges hit since the last merge into a shared bitmap, then clears them.
+         * @param shared A bitmap of `size()` bytes, possibly shared with other threads
+         * @return If the bitmap gained new bits
+         */
+        bool merge(std::atomic<byte_t>* shared) noexcept;
+
+        /**
+         * Forgets the edges hit since the last merge.
+         */
+        void clear() noexcept;
+
+    private:
+        [[nodiscard]] static inline size_t hash(address_t address) noexcept
+        {
+            return (size_t(address) * 0x9E3779B1u) >> 7u;
+        }
+    };
+}
+
+#endif
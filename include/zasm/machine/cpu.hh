@@ -44,7 +44,14 @@ namespace zasm
         bool _iff1;
         bool _iff2;
 
+        bool _halted;
+
     public:
+        /**
+         * Creates a new CPU with every register cleared and interrupts disabled.
+         */
+        CPU();
+
         /**
          * Reads the value of a word register passed by template argument.
          * @tparam r A word register
@@ -155,6 +162,12 @@ namespace zasm
          */
         void clearFlags() noexcept;
 
+        /**
+         * Increments the 7 lower bits of the R register, as done by every opcode fetch.
+         * @param fetches The number of opcode fetches
+         */
+        void refresh(uint64_t fetches = 1) noexcept;
+
         [[nodiscard]] inline bool iff1() const noexcept
         {
             return _iff1;
@@ -174,6 +187,19 @@ namespace zasm
         {
             return _iff2;
         }
+
+        /**
+         * Indicates if the CPU executed a `HALT` instruction and is waiting for an interrupt.
+         */
+        [[nodiscard]] inline bool halted() const noexcept
+        {
+            return _halted;
+        }
+
+        [[nodiscard]] inline bool& halted() noexcept
+        {
+            return _halted;
+        }
     };
 }
 
@@ -0,0 +1,242 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__DEVICES__
+#define __ZASM__MACHINE__DEVICES__
+
+#if !defined(__cpp_impl_coroutine)
+#error "zasm/machine/devices.hh requires C++20 coroutines"
+#endif
+
+#include "zasm/machine/machine.hh"
+
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace zasm
+{
+    class Devices;
+
+    /**
+     * The coroutine of a device, which does nothing until spawned by `Devices::spawn`.
+     */
+    class Task final
+    {
+    public:
+        struct promise_type
+        {
+            Task get_return_object() noexcept;
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_always final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_void() noexcept
+            {
+            }
+
+            void unhandled_exception() noexcept;
+        };
+
+    private:
+        std::coroutine_handle<promise_type> _handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept;
+
+        friend class Devices;
+
+    public:
+        Task(Task&& other) noexcept;
+
+        /**
+         * Destroys the coroutine, unless it was spawned.
+         */
+        ~Task();
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(Task&&) = delete;
+    };
+
+    /**
+     * Peripherals of a machine written as coroutines, only resumed by the scheduler of the machine once what they wait
+     * for is due, so that they cost nothing while instructions execute.
+     *
+     * A device awaits a number of cycles, a write to a port, or the acknowledgement of an interrupt:
+     *
+     *     zasm::Task timer(zasm::Devices& devices, zasm::Machine& machine)
+     *     {
+     *         for (;;)
+     *         {
+     *             co_await devices.cycles(70000);
+     *             machine.interrupt();
+     *             co_await devices.acknowledged();
+     *         }
+     *     }
+     *
+     * Devices are always resumed between two instructions.  Each device keeps its own time, the cycle at which it was
+     * last resumed, from which it awaits cycles, so that periodic devices do not drift when instructions end past
+     * their deadline.  Devices are not part of the snapshots of the machine.
+     *
+     * The devices keep a reference to their machine, which must outlive them.  Once the devices are destroyed, their
+     * ports stay on the bus ignoring writes, and the events they scheduled do nothing.
+     */
+    class Devices final
+    {
+    private:
+        class Port;
+
+        Machine& _machine;
+        uint64_t _now;
+        std::vector<std::coroutine_handle<>> _tasks;
+        std::unordered_map<address_t, Port*> _ports;
+        std::vector<std::coroutine_handle<>> _acknowledging;
+        size_t _listener;
+
+        /**
+         * Expires once the devices are destroyed, for the events they scheduled.
+         */
+        std::shared_ptr<bool> _alive;
+
+    public:
+        /**
+         * Waits for a number of cycles since the device was last resumed.
+         */
+        class Delay final
+        {
+        private:
+            Devices& _devices;
+            uint64_t _cycles;
+
+        public:
+            Delay(Devices& devices, uint64_t cycles) noexcept;
+
+            [[nodiscard]] bool await_ready() const noexcept;
+
+            void await_suspend(std::coroutine_handle<> handle);
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        /**
+         * Waits for the guest to write to a port, resuming with the written byte.
+         */
+        class Write final
+        {
+        private:
+            Devices& _devices;
+            address_t _port;
+            byte_t _value;
+
+        public:
+            Write(Devices& devices, address_t port) noexcept;
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle);
+
+            [[nodiscard]] byte_t await_resume() const noexcept
+            {
+                return _value;
+            }
+        };
+
+        /**
+         * Waits for the CPU to accept an interrupt.
+         */
+        class Acknowledge final
+        {
+        private:
+            Devices& _devices;
+
+        public:
+            explicit Acknowledge(Devices& devices) noexcept;
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle);
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        /**
+         * Creates devices for a machine, without any device.
+         * @param machine The machine of the devices
+         */
+        explicit Devices(Machine& machine);
+
+        /**
+         * Destroys every device, detaching them from the machine.
+         */
+        ~Devices();
+
+        Devices(const Devices&) = delete;
+        Devices& operator=(const Devices&) = delete;
+
+        /**
+         * Starts a device once the machine runs, at its current cycle.
+         * @param task The coroutine of the device
+         */
+        void spawn(Task task);
+
+        /**
+         * Gets the time of the device being resumed, the cycle for which it was resumed.
+         */
+        [[nodiscard]] inline uint64_t now() const noexcept
+        {
+            return _now;
+        }
+
+        /**
+         * Waits for a number of cycles since the device was last resumed.
+         * @param count The number of cycles
+         */
+        [[nodiscard]] inline Delay cycles(uint64_t count) noexcept
+        {
+            return Delay(*this, count);
+        }
+
+        /**
+         * Waits for the next write of the guest to a port, attaching the port to the bus the first time it is awaited.
+         * @param port The address of the port
+         */
+        [[nodiscard]] inline Write written(address_t port) noexcept
+        {
+            return Write(*this, port);
+        }
+
+        /**
+         * Waits for the CPU to accept an interrupt.
+         */
+        [[nodiscard]] inline Acknowledge acknowledged() noexcept
+        {
+            return Acknowledge(*this);
+        }
+
+    private:
+        void resume(uint64_t cycle, std::coroutine_handle<> handle);
+
+        void acknowledge();
+    };
+}
+
+#endif
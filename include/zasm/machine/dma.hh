@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__DMA__
+#define __ZASM__MACHINE__DMA__
+
+#include "zasm/machine/bus.hh"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace zasm
+{
+    /**
+     * A bus component copying ranges of the bus on request of the guest, using bulk bus accesses.
+     *
+     * The controller occupies seven addresses: the source address, the destination address and the length of the
+     * transfer as little endian words, followed by a control register.  Writing 1 to the control register performs the
+     * transfer at once, a length of 0 standing for the whole address space.  The source range is read entirely before
+     * the destination range is written, so overlapping ranges behave like `memmove`.  A transfer whose destination
+     * covers the control register does not start another one.
+     *
+     * The controller keeps a reference to its bus, which must not be moved while the controller is attached.
+     */
+    class DMA : public BusComponent
+    {
+    private:
+        Bus& _bus;
+        address_t _address;
+        std::array<byte_t, 6> _registers;
+        std::vector<byte_t> _buffer;
+        bool _busy;
+
+    public:
+        /**
+         * The offsets of the registers of the controller.
+         */
+        enum Register
+        {
+            SOURCE = 0,
+            DESTINATION = 2,
+            LENGTH = 4,
+            CONTROL = 6,
+        };
+
+        /**
+         * Creates a new DMA controller.
+         * @param bus The bus on which transfers are made
+         * @param address The address of the first register of the controller
+         */
+        DMA(Bus& bus, address_t address);
+
+        /**
+         * Copies a range of the bus to another one, unless a transfer is already in progress.
+         * @param source The address of the first byte to copy
+         * @param destination The address where the first byte is copied
+         * @param length The number of bytes to copy, up to `ADDRESS_SPACE`
+         */
+        void transfer(address_t source, address_t destination, size_t length) noexcept;
+
+        [[nodiscard]] byte_t read(address_t address) const noexcept override;
+
+        void write(address_t address, byte_t byte) noexcept override;
+
+        [[nodiscard]] bool accept_read(address_t address) const noexcept override;
+
+        [[nodiscard]] bool accept_write(address_t address) const noexcept override;
+
+        [[nodiscard]] bool idempotent(address_t address) const noexcept override;
+
+        [[nodiscard]] size_t extent(address_t address) const noexcept override;
+    };
+}
+
+#endif
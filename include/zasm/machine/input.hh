@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__INPUT__
+#define __ZASM__MACHINE__INPUT__
+
+#include "zasm/machine/bus.hh"
+
+#include <cstddef>
+#include <vector>
+
+namespace zasm
+{
+    /**
+     * A bus component feeding a stream of bytes to the guest, such as the input of a fuzzer.
+     *
+     * The device occupies two addresses.  Reading the first one consumes the next byte of the input, or returns 0
+     * once the input is exhausted.  Reading the second one returns 1 while bytes remain, and 0 afterwards.
+     */
+    class InputDevice : public BusComponent
+    {
+    private:
+        address_t _address;
+        std::vector<byte_t> _input;
+        mutable size_t _position;
+
+    public:
+        /**
+         * Creates a new input device without any input.
+         * @param address The address of the data register, followed by the status register
+         */
+        explicit InputDevice(address_t address);
+
+        /**
+         * Replaces the input of this device and rewinds it.
+         * @param data The new input
+         * @param size The number of bytes of the new input
+         */
+        void feed(const byte_t* data, size_t size);
+
+        /**
+         * Appends a byte to the input of this device, such as a key typed by a user.
+         * @param byte The byte to append
+         */
+        void append(byte_t byte);
+
+        /**
+         * Gets the number of bytes consumed by the guest.
+         * @return The number of bytes
+         */
+        [[nodiscard]] inline size_t consumed() const noexcept
+        {
+            return _position;
+        }
+
+        [[nodiscard]] byte_t read(address_t address) const noexcept override;
+
+        void write(address_t address, byte_t byte) noexcept override;
+
+        [[nodiscard]] bool accept_read(address_t address) const noexcept override;
+
+        [[nodiscard]] bool idempotent(address_t address) const noexcept override;
+
+        [[nodiscard]] size_t extent(address_t address) const noexcept override;
+
+        void restore() noexcept override;
+    };
+}
+
+#endif
@@ -0,0 +1,225 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__MACHINE__
+#define __ZASM__MACHINE__MACHINE__
+
+#include "zasm/machine/bus.hh"
+#include "zasm/machine/cpu.hh"
+#include "zasm/machine/metrics.hh"
+#include "zasm/machine/scheduler.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace zasm
+{
+    class Coverage;
+    class Profiler;
+    struct CompiledCode;
+
+    /**
+     * A CPU linked to a bus, executing the instructions found on that bus.
+     *
+     * When running, the machine skips idle time straight to the next scheduled event: while the CPU is halted, and
+     * while it spins on a `ld a,(nn) / and n / jr z` or `jr nz` loop polling an idempotent address.  Skipped time is
+     * accounted for exactly, in cycles, executed instructions and refreshes of the R register.
+     *
+     * Firmware recompiled ahead of time runs in place of the interpreter, with the same results.
+     */
+    class Machine final
+    {
+    private:
+        CPU _cpu;
+        Bus _bus;
+        Scheduler _scheduler;
+
+        bool _interrupt;
+        bool _deferred;
+        std::vector<std::function<void()>> _acknowledgeListeners;
+
+        uint64_t _cycles;
+        uint64_t _instructions;
+        uint64_t _nanoseconds;
+
+        uint64_t _publishedInstructions;
+        uint64_t _publishedCycles;
+        uint64_t _publishedNanoseconds;
+        ComponentMetrics _publishedAccesses;
+        Profiler* _profiler;
+        Coverage* _coverage;
+        const CompiledCode* _compiled;
+
+        /**
+         * The cycles executed by the recompiled code running, which the machine only accounts for once it returns.
+         */
+        const uint64_t* _compiledCycles;
+
+        CPU _snapshot;
+        bool _snapshotInterrupt;
+        bool _snapshotDeferred;
+
+        friend class Image;
+
+    public:
+        /**
+         * Creates a new machine with a cleared CPU and a bus without any attached components.
+         */
+        Machine();
+
+        Machine(const Machine&) = delete;
+        Machine& operator=(const Machine&) = delete;
+
+        Machine(Machine&&) = default;
+        Machine& operator=(Machine&&) = default;
+
+        [[nodiscard]] inline CPU& cpu() noexcept
+        {
+            return _cpu;
+        }
+
+        [[nodiscard]] inline const CPU& cpu() const noexcept
+        {
+            return _cpu;
+        }
+
+        [[nodiscard]] inline Bus& bus() noexcept
+        {
+            return _bus;
+        }
+
+        [[nodiscard]] inline const Bus& bus() const noexcept
+        {
+            return _bus;
+        }
+
+        [[nodiscard]] inline Scheduler& scheduler() noexcept
+        {
+            return _scheduler;
+        }
+
+        /**
+         * Requests a maskable interrupt, which stays pending until the CPU accepts it.
+         *
+         * The interrupt is accepted before the next instruction executed while interrupts are enabled, except right
+         * after `EI`.  The CPU behaves as in interrupt mode 1, calling 0x0038.
+         */
+        inline void interrupt() noexcept
+        {
+            _interrupt = true;
+        }
+
+        /**
+         * Indicates if an interrupt was requested and not accepted yet.
+         */
+        [[nodiscard]] inline bool interrupted() const noexcept
+        {
+            return _interrupt;
+        }
+
+        /**
+         * Adds a function called whenever the CPU accepts an interrupt, before the interrupt routine executes.
+         * @param listener The function to call
+         * @return The identifier of the listener, to remove it
+         */
+        size_t on_acknowledge(std::function<void()> listener);
+
+        /**
+         * Removes a function added by `on_acknowledge`.
+         * @param identifier The identifier of the listener
+         */
+        void remove_acknowledge(size_t identifier) noexcept;
+
+        /**
+         * Gets the number of cycles executed since this machine was created.
+         *
+         * From within an instruction, such as when a component is accessed, this is the cycle at which the instruction
+         * started, whether it is interpreted or recompiled.
+         * @return The number of cycles
+         */
+        [[nodiscard]] inline uint64_t cycles() const noexcept
+        {
+            return _compiledCycles != nullptr ? _cycles + *_compiledCycles : _cycles;
+        }
+
+        /**
+         * Gets a snapshot of the counters of this machine since it was created.
+         *
+         * Must be called from the thread running the machine, or while it is not running.  Other threads should use
+         * `Metrics::collect` instead.
+         * @return The counters of this machine
+         */
+        [[nodiscard]] Metrics metrics() const;
+
+        /**
+         * Attaches a profiler to which executed instructions are reported.
+         *
+         * The profiler is not owned by the machine and must outlive it or be detached.
+         * @param profiler A profiler, or `nullptr` to detach the current one
+         */
+        void attach(Profiler* profiler) noexcept;
+
+        /**
+         * Attaches a coverage table to which taken branches are reported.
+         *
+         * The coverage table is not owned by the machine and must outlive it or be detached.
+         * @param coverage A coverage table, or `nullptr` to detach the current one
+         */
+        void attach(Coverage* coverage) noexcept;
+
+        /**
+         * Attaches firmware recompiled ahead of time, run in place of the interpreter whenever PC is in recompiled
+         * code, unless a profiler or a coverage table is attached.
+         *
+         * The code is not owned by the machine and must outlive it or be detached.  It is only attached if the bus
+         * already holds the firmware, entirely in ROM components, so that the recompiled code stays faithful to it.
+         * @param code Recompiled code matching the bus of this machine, or `nullptr` to detach the current one
+         * @return Whether the code was attached, the current one staying attached otherwise
+         */
+        [[nodiscard]] bool attach(const CompiledCode* code);
+
+        /**
+         * Remembers the state of the CPU and of every bus component, so that it can be restored later on.
+         */
+        void snapshot();
+
+        /**
+         * Restores the CPU and every bus component to the state of the last snapshot.
+         *
+         * Restoring is meant to be cheap enough to reset a machine between two short executions, RAM components only
+         * copying back the pages written since the snapshot.  The counters of the machine are left untouched, and so is
+         * its scheduler, whose events are due at absolute cycles: executions restarted from a snapshot only replay
+         * identically when no event is scheduled.
+         */
+        void restore() noexcept;
+
+        /**
+         * Runs the events that are due, then accepts a pending interrupt or executes the instruction at PC.
+         *
+         * A halted CPU executes a single cycle, without fetching anything.
+         * @return The number of cycles taken, or 0 if the instruction is not implemented, in which case the CPU is
+         *         left untouched
+         */
+        size_t step();
+
+        /**
+         * Executes instructions until at least the given number of cycles have elapsed, or until an instruction is
+         * not implemented, then publishes the counters of this machine to the calling thread.
+         * @param cycles The number of cycles to execute
+         * @return The number of cycles that were executed
+         */
+        uint64_t run(uint64_t cycles);
+
+    private:
+        size_t acknowledge();
+
+        void idle(uint64_t until);
+
+        void spin(uint64_t until);
+
+        bool execute(uint64_t until);
+    };
+}
+
+#endif
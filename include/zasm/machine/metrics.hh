@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__METRICS__
+#define __ZASM__MACHINE__METRICS__
+
+#include <cstdint>
+#include <vector>
+
+namespace zasm
+{
+    /**
+     * Counters of the accesses a bus made to one of its components.
+     */
+    struct ComponentMetrics
+    {
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+
+        /**
+         * The number of bulk reads and writes, each of them also counting its bytes as reads or writes.
+         */
+        uint64_t spans = 0;
+    };
+
+    /**
+     * Host side counters of the work done while emulating machines.
+     *
+     * A machine counts its work in plain integers while it runs, and publishes it to counters owned by the running
+     * thread once every call to `Machine::run`.  Publishing is a plain load and store by the only writer of those
+     * counters, so the hot loop never uses atomic read-modify-write operations, and `collect` can aggregate the
+     * counters of every thread whenever needed.
+     */
+    struct Metrics
+    {
+        uint64_t instructions = 0;
+        uint64_t cycles = 0;
+        uint64_t nanoseconds = 0;
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t spans = 0;
+
+        /**
+         * The accesses made to each component of a single bus, left empty in aggregated metrics.
+         */
+        std::vector<ComponentMetrics> components;
+
+        /**
+         * Computes the emulated frequency, in millions of cycles per second of host time spent running.
+         * @return The emulated frequency
+         */
+        [[nodiscard]] double mhz() const noexcept;
+
+        /**
+         * Adds the counters of other metrics to these ones.
+         * @param other Other metrics
+         * @return These metrics
+         */
+        Metrics& operator+=(const Metrics& other);
+
+        /**
+         * Adds the given counters to the ones of the calling thread.
+         * @param delta The work done since the last publication
+         */
+        static void publish(const Metrics& delta);
+
+        /**
+         * Aggregates the counters published by every thread, including threads that have exited.
+         * @return The aggregated metrics
+         */
+        [[nodiscard]] static Metrics collect();
+    };
+}
+
+#endif
@@ -0,0 +1,120 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__PROFILER__
+#define __ZASM__MACHINE__PROFILER__
+
+#include "zasm/types.hh"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace zasm
+{
+    /**
+     * A profiler attributing the cycles executed by a machine to guest addresses and guest call stacks.
+     *
+     * Cycles are always counted exactly per address, in lazily allocated tables of 256 counters indexed by the page
+     * and the offset of the address.  Call stacks are reconstructed from the `CALL` and `RET` instructions and are
+     * only sampled every *interval* cycles, each sample being weighted by the interval.  An interval of 1 makes the
+     * call stacks exact.
+     */
+    class Profiler final
+    {
+    private:
+        using Page = std::array<uint64_t, 256>;
+
+        /**
+         * A node of the reconstructed call tree.
+         */
+        struct Frame
+        {
+            address_t routine;
+            size_t parent;
+            uint64_t calls;
+            uint64_t cycles;
+        };
+
+        std::array<std::unique_ptr<Page>, 256> _pages;
+
+        std::vector<Frame> _frames;
+        std::unordered_map<uint64_t, size_t> _children;
+        size_t _current;
+        size_t _depth;
+        size_t _overflow;
+
+        uint64_t _interval;
+        int64_t _countdown;
+        uint64_t _total;
+
+    public:
+        /**
+         * The maximum depth of the reconstructed call stacks, deeper calls being attributed to the deepest frame.
+         */
+        static constexpr size_t MAX_DEPTH = 256;
+
+        /**
+         * Creates a new profiler.
+         * @param interval The number of cycles between two samples of the call stack
+         */
+        explicit Profiler(uint64_t interval = 1);
+
+        /**
+         * Attributes the cycles of an executed instruction.
+         * @param address The address of the instruction
+         * @param cycles The number of cycles it took
+         */
+        void retire(address_t address, size_t cycles);
+
+        /**
+         * Enters a routine, as done by a `CALL` instruction.
+         * @param routine The address of the called routine
+         */
+        void call(address_t routine);
+
+        /**
+         * Leaves the current routine, as done by a `RET` instruction.
+         */
+        void ret() noexcept;
+
+        /**
+         * Forgets everything that was recorded.
+         */
+        void reset();
+
+        /**
+         * Gets the number of cycles executed by the instruction at the given address.
+         * @param address An address
+         * @return The number of cycles
+         */
+        [[nodiscard]] uint64_t cycles(address_t address) const noexcept;
+
+        /**
+         * Gets the total number of cycles that were recorded.
+         * @return The number of cycles
+         */
+        [[nodiscard]] uint64_t total() const noexcept;
+
+        /**
+         * Writes the sampled call stacks in the folded format understood by flame graph tools.
+         *
+         * Every line holds the routines of a stack separated by semicolons, followed by the number of cycles spent in
+         * the last routine of that stack.
+         * @param output The stream to write to
+         */
+        void write_folded(std::ostream& output) const;
+
+        /**
+         * Writes a table of the number of calls, self cycles and total cycles of every sampled routine, ordered by
+         * decreasing self cycles.
+         * @param output The stream to write to
+         */
+        void write_routines(std::ostream& output) const;
+    };
+}
+
+#endif
@@ -0,0 +1,220 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__QUEUES__
+#define __ZASM__MACHINE__QUEUES__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace zasm
+{
+    /**
+     * The size of the cache lines kept apart between producers and consumers.
+     */
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * Rounds the capacity of a queue up to the power of two it must be, with at least two items, since a single cell
+     * could not tell a full queue from an empty one.
+     */
+    [[nodiscard]] constexpr size_t queue_capacity(size_t capacity) noexcept
+    {
+        size_t rounded = 2;
+        while (rounded < capacity)
+        {
+            rounded <<= 1u;
+        }
+
+        return rounded;
+    }
+
+    /**
+     * A bounded, lock-free queue with any number of producers and a single consumer.
+     *
+     * Each cell carries a sequence number telling whether it is ready to be written or read for a given position,
+     * so that producers only contend on claiming a position, and the consumer never writes to a shared counter.
+     * @tparam T The type of items, which must be default constructible
+     */
+    template<typename T>
+    class MPSCQueue final
+    {
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> _cells;
+        size_t _mask;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail;
+        alignas(CACHE_LINE_SIZE) size_t _head;
+
+    public:
+        /**
+         * Creates a new empty queue.
+         * @param capacity The maximum number of items in the queue, rounded up to a power of two
+         */
+        explicit MPSCQueue(size_t capacity)
+            : _cells(new Cell[queue_capacity(capacity)])
+            , _mask(queue_capacity(capacity) - 1)
+            , _tail(0)
+            , _head(0)
+        {
+            for (size_t i = 0; i <= _mask; ++i)
+            {
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        /**
+         * Adds an item at the back of the queue, from any thread.
+         * @param value The item to add
+         * @return If the item was added, or false if the queue is full
+         */
+        bool push(T value) noexcept
+        {
+            auto position = _tail.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto& cell = _cells[position & _mask];
+                auto difference = intptr_t(cell.sequence.load(std::memory_order_acquire)) - intptr_t(position);
+
+                if (difference == 0)
+                {
+                    if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = std::move(value);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = _tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * Removes the item at the front of the queue, from the consumer thread only.
+         * @param value Receives the removed item
+         * @return If an item was removed, or false if the queue is empty
+         */
+        bool pop(T& value) noexcept
+        {
+            auto& cell = _cells[_head & _mask];
+            if (cell.sequence.load(std::memory_order_acquire) != _head + 1)
+            {
+                return false;
+            }
+
+            value = std::move(cell.value);
+            cell.sequence.store(_head + _mask + 1, std::memory_order_release);
+            _head += 1;
+
+            return true;
+        }
+    };
+
+    /**
+     * A bounded, lock-free queue with a single producer and a single consumer.
+     *
+     * Each side keeps a copy of the other side's index, only reloading it when the queue looks full or empty, so that
+     * the cache lines of both indices are rarely exchanged.
+     * @tparam T The type of items, which must be default constructible
+     */
+    template<typename T>
+    class SPSCQueue final
+    {
+    private:
+        std::unique_ptr<T[]> _items;
+        size_t _mask;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _tail;
+        size_t _cachedHead;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _head;
+        size_t _cachedTail;
+
+    public:
+        /**
+         * Creates a new empty queue.
+         * @param capacity The maximum number of items in the queue, rounded up to a power of two
+         */
+        explicit SPSCQueue(size_t capacity)
+            : _items(new T[queue_capacity(capacity)]())
+            , _mask(queue_capacity(capacity) - 1)
+            , _tail(0)
+            , _cachedHead(0)
+            , _head(0)
+            , _cachedTail(0)
+        {
+        }
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        /**
+         * Adds an item at the back of the queue, from the producer thread only.
+         * @param value The item to add
+         * @return If the item was added, or false if the queue is full
+         */
+        bool push(T value) noexcept
+        {
+            auto tail = _tail.load(std::memory_order_relaxed);
+
+            if (tail - _cachedHead > _mask)
+            {
+                _cachedHead = _head.load(std::memory_order_acquire);
+                if (tail - _cachedHead > _mask)
+                {
+                    return false;
+                }
+            }
+
+            _items[tail & _mask] = std::move(value);
+            _tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /**
+         * Removes the item at the front of the queue, from the consumer thread only.
+         * @param value Receives the removed item
+         * @return If an item was removed, or false if the queue is empty
+         */
+        bool pop(T& value) noexcept
+        {
+            auto head = _head.load(std::memory_order_relaxed);
+
+            if (head == _cachedTail)
+            {
+                _cachedTail = _tail.load(std::memory_order_acquire);
+                if (head == _cachedTail)
+                {
+                    return false;
+                }
+            }
+
+            value = std::move(_items[head & _mask]);
+            _head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+    };
+}
+
+#endif
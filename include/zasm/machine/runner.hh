@@ -0,0 +1,265 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__RUNNER__
+#define __ZASM__MACHINE__RUNNER__
+
+#include "zasm/machine/input.hh"
+#include "zasm/machine/machine.hh"
+#include "zasm/machine/queues.hh"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace zasm
+{
+    /**
+     * Runs a machine on a dedicated thread, in time slices, for frontends living on other threads.
+     *
+     * Frontends send commands from any thread, which the runner applies between time slices, and receive events on a
+     * single thread.  Both queues are lock-free and bounded: sending a command fails when its queue is full, and
+     * events published when their queue is full are dropped and counted.  While paused, the runner sleeps for one
+     * time slice at a time, so that commands always take effect within a time slice.
+     *
+     * Once started, the machine must only be accessed through commands until the runner is stopped.
+     */
+    class Runner final
+    {
+    public:
+        /**
+         * A request sent to the thread of a runner.
+         */
+        struct Command
+        {
+            enum class Type
+            {
+                Pause,
+                Resume,
+                Step,
+                Poke,
+                Input,
+                Breakpoint,
+                Snapshot,
+                Restore,
+            };
+
+            Type type = Type::Pause;
+            address_t address = 0;
+            byte_t value = 0;
+            uint64_t count = 0;
+        };
+
+        /**
+         * A notification published by the thread of a runner.
+         */
+        struct Event
+        {
+            enum class Type
+            {
+                /**
+                 * A time slice was executed, ending at `cycle`.
+                 */
+                Frame,
+                /**
+                 * The machine paused before executing the breakpoint at `address`.
+                 */
+                Breakpoint,
+                /**
+                 * The machine paused at `address`, once paused or done stepping.
+                 */
+                Paused,
+                /**
+                 * The guest wrote `value` to the output port.
+                 */
+                Output,
+                /**
+                 * The machine paused on the unimplemented instruction at `address`.
+                 */
+                Fault,
+                /**
+                 * A snapshot of the machine was taken.
+                 */
+                Snapshot,
+            };
+
+            Type type = Type::Frame;
+            uint64_t cycle = 0;
+            address_t address = 0;
+            byte_t value = 0;
+        };
+
+        struct Options
+        {
+            /**
+             * The number of cycles executed between two checks of the commands.
+             */
+            uint64_t slice = 70000;
+
+            /**
+             * The frequency of the emulated CPU in cycles per second, or 0 to run as fast as possible.
+             */
+            uint64_t frequency = 3500000;
+
+            /**
+             * The address of the port whose writes are published as output events, if any.
+             */
+            std::optional<address_t> output;
+
+            /**
+             * The device receiving input commands, if any.
+             */
+            InputDevice* input = nullptr;
+
+            /**
+             * The capacities of the command and event queues, rounded up to powers of two.
+             */
+            size_t commands = 1024;
+            size_t events = 4096;
+        };
+
+    private:
+        class Port;
+
+        Machine& _machine;
+        Options _options;
+        std::chrono::nanoseconds _period;
+
+        MPSCQueue<Command> _commands;
+        SPSCQueue<Event> _events;
+        std::atomic<uint64_t> _dropped;
+
+        std::vector<bool> _breakpoints;
+        size_t _breakpointCount;
+        bool _paused;
+        bool _resumed;
+
+        std::atomic<bool> _stopping;
+        std::thread _thread;
+        Port* _port;
+
+    public:
+        /**
+         * Creates a new paused runner for a machine, attaching the output port to its bus.
+         * @param machine The machine to run, which must outlive this runner
+         * @param options The options of this runner
+         */
+        Runner(Machine& machine, Options options);
+
+        /**
+         * Stops this runner.  Its output port stays on the bus of the machine, ignoring writes.
+         */
+        ~Runner();
+
+        Runner(const Runner&) = delete;
+        Runner& operator=(const Runner&) = delete;
+
+        /**
+         * Starts the thread of this runner.  The machine stays paused until resumed.
+         */
+        void start();
+
+        /**
+         * Stops the thread of this runner after its current time slice, waiting for it to finish.
+         */
+        void stop();
+
+        /**
+         * Sends a command to this runner, from any thread.
+         * @param command The command to send
+         * @return If the command was sent, or false if too many commands are pending
+         */
+        inline bool send(const Command& command) noexcept
+        {
+            return _commands.push(command);
+        }
+
+        inline bool pause() noexcept
+        {
+            return send({ Command::Type::Pause });
+        }
+
+        inline bool resume() noexcept
+        {
+            return send({ Command::Type::Resume });
+        }
+
+        /**
+         * Executes instructions while paused, then publishes a paused event.
+         * @param count The number of instructions to execute
+         */
+        inline bool step(uint64_t count = 1) noexcept
+        {
+            return send({ Command::Type::Step, 0, 0, count });
+        }
+
+        /**
+         * Writes a byte on the bus, as the guest would.
+         */
+        inline bool poke(address_t address, byte_t value) noexcept
+        {
+            return send({ Command::Type::Poke, address, value });
+        }
+
+        /**
+         * Appends a byte to the input device.
+         */
+        inline bool input(byte_t value) noexcept
+        {
+            return send({ Command::Type::Input, 0, value });
+        }
+
+        /**
+         * Sets or clears a breakpoint, pausing the machine before it executes the instruction at an address.
+         */
+        inline bool breakpoint(address_t address, bool enabled = true) noexcept
+        {
+            return send({ Command::Type::Breakpoint, address, byte_t(enabled) });
+        }
+
+        inline bool snapshot() noexcept
+        {
+            return send({ Command::Type::Snapshot });
+        }
+
+        inline bool restore() noexcept
+        {
+            return send({ Command::Type::Restore });
+        }
+
+        /**
+         * Receives the next event of this runner, from a single thread.
+         * @param event Receives the event
+         * @return If an event was received
+         */
+        inline bool poll(Event& event) noexcept
+        {
+            return _events.pop(event);
+        }
+
+        /**
+         * Gets the number of events dropped because the frontend did not poll them in time.
+         */
+        [[nodiscard]] inline uint64_t dropped() const noexcept
+        {
+            return _dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void loop();
+
+        void apply(const Command& command);
+
+        void execute(uint64_t cycles);
+
+        void step_instructions(uint64_t count);
+
+        [[nodiscard]] bool stopped_at_breakpoint();
+
+        void publish(Event::Type type, address_t address = 0, byte_t value = 0) noexcept;
+    };
+}
+
+#endif
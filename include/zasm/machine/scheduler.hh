@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__SCHEDULER__
+#define __ZASM__MACHINE__SCHEDULER__
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace zasm
+{
+    /**
+     * A queue of events to run once a machine reaches given cycles, such as the timers of devices.
+     *
+     * Devices are expected to only change what the guest can observe from within scheduled events, which lets the
+     * machine skip idle time up to the next event.
+     */
+    class Scheduler final
+    {
+    public:
+        using Action = std::function<void()>;
+
+        /**
+         * The cycle returned by `next` when no event is scheduled.
+         */
+        static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+    private:
+        struct Event
+        {
+            uint64_t cycle;
+            uint64_t sequence;
+            Action action;
+        };
+
+        std::vector<Event> _events;
+        uint64_t _sequence;
+        uint64_t _next;
+
+    public:
+        /**
+         * Creates a new scheduler without any event.
+         */
+        Scheduler();
+
+        /**
+         * Schedules an action to run once the machine reaches the given cycle, after the actions already scheduled
+         * for the same cycle.
+         * @param cycle The cycle at which to run the action
+         * @param action The action to run
+         */
+        void schedule(uint64_t cycle, Action action);
+
+        /**
+         * Gets the cycle of the next event.
+         * @return The cycle of the next event, or `NEVER` if no event is scheduled
+         */
+        [[nodiscard]] inline uint64_t next() const noexcept
+        {
+            return _next;
+        }
+
+        /**
+         * Runs every event due at the given cycle, including the ones they schedule for it.
+         * @param cycle The current cycle
+         */
+        void fire(uint64_t cycle);
+    };
+}
+
+#endif
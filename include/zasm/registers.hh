@@ -28,16 +28,47 @@ namespace zasm
     struct Register
     {
         word_t word;
-        union
-        {
-            byte_t lowByte;
-            byte_t highByte;
-        };
 
         /**
          * Creates a new zero initialized register.
          */
         Register();
+
+        /**
+         * Reads the least significant byte of this register.
+         * @return The low byte
+         */
+        [[nodiscard]] inline byte_t lowByte() const noexcept
+        {
+            return byte_t(word & 0xFFu);
+        }
+
+        /**
+         * Writes the least significant byte of this register.
+         * @param byte The new low byte
+         */
+        inline void lowByte(byte_t byte) noexcept
+        {
+            word = word_t((word & 0xFF00u) | byte);
+        }
+
+        /**
+         * Reads the most significant byte of this register.
+         * @return The high byte
+         */
+        [[nodiscard]] inline byte_t highByte() const noexcept
+        {
+            return byte_t(word >> 8u);
+        }
+
+        /**
+         * Writes the most significant byte of this register.
+         * @param byte The new high byte
+         */
+        inline void highByte(byte_t byte) noexcept
+        {
+            word = word_t((word & 0x00FFu) | (word_t(byte) << 8u));
+        }
     };
 }
 
@@ -3,6 +3,7 @@
 #ifndef __ZASM__TYPES__
 #define __ZASM__TYPES__
 
+#include <cstddef>
 #include <cstdint>
 
 namespace zasm
@@ -21,6 +22,11 @@ namespace zasm
      * The type of an address handled by our emulated CPU.
      */
     using address_t = word_t;
+
+    /**
+     * The number of addresses reachable by our emulated CPU.
+     */
+    constexpr size_t ADDRESS_SPACE = 0x10000;
 }
 
 #endif
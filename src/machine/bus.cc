@@ -2,17 +2,60 @@
 
 #include "meta.hh"
 
+#include <algorithm>
+#include <cstring>
+
 namespace zasm
 {
     Bus::Bus()
         : _components()
+        , _metrics()
     {
     }
 
-    Bus::~Bus() = default;
-
     BusComponent::~BusComponent() = default;
 
+    bool BusComponent::idempotent(address_t address) const noexcept
+    {
+        UNUSED(address);
+        return false;
+    }
+
+    size_t BusComponent::extent(address_t address) const noexcept
+    {
+        UNUSED(address);
+        return 1;
+    }
+
+    void BusComponent::read_span(address_t address, byte_t* bytes, size_t size) const noexcept
+    {
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = read(address_t(address + i));
+        }
+    }
+
+    void BusComponent::write_span(address_t address, const byte_t* bytes, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; ++i) {
+            write(address_t(address + i), bytes[i]);
+        }
+    }
+
+    void BusComponent::snapshot()
+    {
+    }
+
+    void BusComponent::restore() noexcept
+    {
+    }
+
+    BusComponent& Bus::attach(std::unique_ptr<BusComponent> component)
+    {
+        _components.push_back(std::move(component));
+        _metrics.emplace_back();
+        return *_components.back();
+    }
+
     bool BusComponent::accept_read(address_t address) const noexcept
     {
         UNUSED(address);
@@ -25,32 +68,53 @@ namespace zasm
         return false;
     }
 
-    void Bus::write(address_t address, byte_t byte) noexcept
+    void Bus::snapshot()
     {
         for (auto& component : _components) {
-            if (component->accept_write(address)) {
-                component->write(address, byte);
-            }
+            component->snapshot();
         }
     }
 
-    void Bus::write(address_t address, word_t word) noexcept
+    void Bus::restore() noexcept
     {
         for (auto& component : _components) {
-            auto low_byte = (byte_t) (word | 0xFFu);
-            auto high_byte = (byte_t) ((word >> 8u) | 0xFF);
+            component->restore();
+        }
+    }
 
-            if (component->accept_write(address)) {
-                component->write(address, low_byte);
+    void Bus::write(address_t address, byte_t byte) noexcept
+    {
+        for (size_t i = 0; i < _components.size(); ++i) {
+            if (_components[i]->accept_write(address)) {
+                _components[i]->write(address, byte);
+                _metrics[i].writes += 1;
             }
+        }
+    }
 
-            if (component->accept_write(address + 1)) {
-                component->write(address + 1, high_byte);
+    void Bus::write(address_t address, word_t word) noexcept
+    {
+        write(address, (byte_t) (word & 0xFFu));
+        write(address_t(address + 1), (byte_t) ((word >> 8u) & 0xFFu));
+    }
+
+    bool Bus::idempotent(address_t address) const noexcept
+    {
+        for (const auto& component : _components) {
+            if (component->accept_read(address) && !component->idempotent(address)) {
+                return false;
             }
         }
+
+        return true;
     }
 
-    byte_t Bus::read_byte(address_t address) const noexcept
+    void Bus::read_span(address_t address, byte_t* bytes, size_t size) const noexcept
+    {
+        read_span(address, bytes, size, true);
+    }
+
+    byte_t Bus::peek(address_t address) const noexcept
     {
         byte_t byte = 0;
 
@@ -63,29 +127,138 @@ namespace zasm
         return byte;
     }
 
+    void Bus::peek_span(address_t address, byte_t* bytes, size_t size) const noexcept
+    {
+        read_span(address, bytes, size, false);
+    }
+
+    void Bus::read_span(address_t address, byte_t* bytes, size_t size, bool counted) const noexcept
+    {
+        while (size > 0) {
+            auto length = chunk(address, size);
+            auto read = false;
+
+            for (size_t i = 0; i < _components.size(); ++i) {
+                const auto& component = _components[i];
+                if (!component->accept_read(address)) {
+                    continue;
+                }
+
+                if (!read) {
+                    component->read_span(address, bytes, length);
+                    read = true;
+                } else {
+                    // Overlapping components drive the bus together, so their bytes are combined as single reads do.
+                    byte_t buffer[256];
+                    for (size_t offset = 0; offset < length; offset += sizeof(buffer)) {
+                        auto part = std::min(sizeof(buffer), length - offset);
+                        component->read_span(address_t(address + offset), buffer, part);
+
+                        for (size_t j = 0; j < part; ++j) {
+                            bytes[offset + j] |= buffer[j];
+                        }
+                    }
+                }
+
+                if (counted) {
+                    _metrics[i].reads += length;
+                    _metrics[i].spans += 1;
+                }
+            }
+
+            if (!read) {
+                std::memset(bytes, 0, length);
+            }
+
+            address = address_t(address + length);
+            bytes += length;
+            size -= length;
+        }
+    }
+
+    void Bus::write_span(address_t address, const byte_t* bytes, size_t size) noexcept
+    {
+        while (size > 0) {
+            auto length = chunk(address, size);
+
+            for (size_t i = 0; i < _components.size(); ++i) {
+                if (_components[i]->accept_write(address)) {
+                    _components[i]->write_span(address, bytes, length);
+                    _metrics[i].writes += length;
+                    _metrics[i].spans += 1;
+                }
+            }
+
+            address = address_t(address + length);
+            bytes += length;
+            size -= length;
+        }
+    }
+
+    size_t Bus::chunk(address_t address, size_t size) const noexcept
+    {
+        auto length = std::min(size, ADDRESS_SPACE - address);
+
+        for (const auto& component : _components) {
+            length = std::min(length, std::max<size_t>(component->extent(address), 1));
+        }
+
+        return length;
+    }
+
+    byte_t Bus::read_byte(address_t address) const noexcept
+    {
+        byte_t byte = 0;
+
+        for (size_t i = 0; i < _components.size(); ++i) {
+            if (_components[i]->accept_read(address)) {
+                byte |= _components[i]->read(address);
+                _metrics[i].reads += 1;
+            }
+        }
+
+        return byte;
+    }
+
     word_t Bus::read_word(address_t address) const noexcept
     {
         byte_t low_byte = 0;
         byte_t high_byte = 0;
 
-        for (const auto& component : _components) {
+        for (size_t i = 0; i < _components.size(); ++i) {
+            const auto& component = _components[i];
+
             if (component->accept_read(address)) {
                 low_byte |= component->read(address);
+                _metrics[i].reads += 1;
             }
 
             if (component->accept_read((address + 1))) {
                 high_byte |= component->read(address + 1);
+                _metrics[i].reads += 1;
             }
         }
 
         return (((word_t) high_byte) << 8u) | ((word_t) low_byte);
     }
 
-    RAM::RAM(address_t inclusiveStart, address_t exclusiveEnd)
+    RAM::RAM(address_t inclusiveStart, size_t exclusiveEnd)
+        : RAM(inclusiveStart, exclusiveEnd,
+              std::shared_ptr<byte_t>(new byte_t[exclusiveEnd - inclusiveStart](), std::default_delete<byte_t[]>()))
+    {
+    }
+
+    RAM::RAM(address_t inclusiveStart, size_t exclusiveEnd, std::shared_ptr<byte_t> memory)
         : _inclusiveStart(inclusiveStart)
         , _exclusiveEnd(exclusiveEnd)
-        , _memory(size_t(exclusiveEnd - inclusiveStart), byte_t(0))
+        , _storage(std::move(memory))
+        , _memory(_storage.get())
+        , _snapshot()
+        , _dirty((exclusiveEnd - inclusiveStart + PAGE_SIZE - 1) / PAGE_SIZE, false)
+        , _dirtyPages()
     {
+        // Reserving every page up front keeps writes from allocating.
+        _dirtyPages.reserve(_dirty.size());
     }
 
     uint8_t RAM::read(address_t address) const noexcept
@@ -95,7 +268,14 @@ namespace zasm
 
     void RAM::write(address_t address, byte_t byte) noexcept
     {
-        _memory[address - _inclusiveStart] = byte;
+        auto offset = size_t(address - _inclusiveStart);
+        _memory[offset] = byte;
+
+        auto page = offset / PAGE_SIZE;
+        if (!_dirty[page]) {
+            _dirty[page] = true;
+            _dirtyPages.push_back(page);
+        }
     }
 
     bool RAM::accept_read(address_t address) const noexcept
@@ -108,11 +288,83 @@ namespace zasm
         return address >= _inclusiveStart && address < _exclusiveEnd;
     }
 
-    ROM::ROM(address_t inclusiveStart, address_t exclusiveEnd)
+    bool RAM::idempotent(address_t address) const noexcept
+    {
+        UNUSED(address);
+        return true;
+    }
+
+    size_t RAM::extent(address_t address) const noexcept
+    {
+        if (address < _inclusiveStart) {
+            return _inclusiveStart - address;
+        }
+
+        if (address < _exclusiveEnd) {
+            return _exclusiveEnd - address;
+        }
+
+        return ADDRESS_SPACE - address;
+    }
+
+    void RAM::read_span(address_t address, byte_t* bytes, size_t size) const noexcept
+    {
+        std::memcpy(bytes, _memory + (address - _inclusiveStart), size);
+    }
+
+    void RAM::write_span(address_t address, const byte_t* bytes, size_t size) noexcept
+    {
+        if (size == 0) {
+            return;
+        }
+
+        auto offset = size_t(address - _inclusiveStart);
+        std::memcpy(_memory + offset, bytes, size);
+
+        for (auto page = offset / PAGE_SIZE; page <= (offset + size - 1) / PAGE_SIZE; ++page) {
+            if (!_dirty[page]) {
+                _dirty[page] = true;
+                _dirtyPages.push_back(page);
+            }
+        }
+    }
+
+    void RAM::snapshot()
+    {
+        _snapshot.assign(_memory, _memory + (_exclusiveEnd - _inclusiveStart));
+
+        for (auto page : _dirtyPages) {
+            _dirty[page] = false;
+        }
+        _dirtyPages.clear();
+    }
+
+    void RAM::restore() noexcept
+    {
+        if (_snapshot.empty()) {
+            return;
+        }
+
+        for (auto page : _dirtyPages) {
+            auto offset = page * PAGE_SIZE;
+            auto size = std::min(PAGE_SIZE, _snapshot.size() - offset);
+            std::memcpy(_memory + offset, _snapshot.data() + offset, size);
+
+            _dirty[page] = false;
+        }
+        _dirtyPages.clear();
+    }
+
+    ROM::ROM(address_t inclusiveStart, size_t exclusiveEnd)
         : RAM(inclusiveStart, exclusiveEnd)
     {
     }
 
+    ROM::ROM(address_t inclusiveStart, size_t exclusiveEnd, std::shared_ptr<byte_t> memory)
+        : RAM(inclusiveStart, exclusiveEnd, std::move(memory))
+    {
+    }
+
     bool ROM::accept_write(address_t address) const noexcept
     {
         UNUSED(address);
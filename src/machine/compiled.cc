@@ -0,0 +1,26 @@
+#include "zasm/machine/compiled.hh"
+
+#include <vector>
+
+namespace zasm
+{
+    uint64_t CompiledCode::hash(const byte_t* bytes, size_t size) noexcept
+    {
+        uint64_t hash = 0xCBF29CE484222325u;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 0x100000001B3u;
+        }
+
+        return hash;
+    }
+
+    bool CompiledCode::matches(const Bus& bus) const
+    {
+        std::vector<byte_t> firmware(end - start);
+        bus.peek_span(start, firmware.data(), firmware.size());
+
+        return hash(firmware.data(), firmware.size()) == checksum;
+    }
+}
@@ -0,0 +1,89 @@
+#include "zasm/machine/coverage.hh"
+
+namespace zasm
+{
+    namespace
+    {
+        /**
+         * Maps a hit count to its class, so that changes within a class are not considered new coverage.
+         */
+        constexpr byte_t bucket(byte_t hits) noexcept
+        {
+            if (hits <= 3)
+            {
+                return byte_t(1u << (hits - 1u));
+            }
+            else if (hits <= 7)
+            {
+                return 1u << 3u;
+            }
+            else if (hits <= 15)
+            {
+                return 1u << 4u;
+            }
+            else if (hits <= 31)
+            {
+                return 1u << 5u;
+            }
+            else if (hits <= 127)
+            {
+                return 1u << 6u;
+            }
+
+            return 1u << 7u;
+        }
+
+        size_t round_up(size_t size) noexcept
+        {
+            size_t rounded = 1;
+            while (rounded < size)
+            {
+                rounded <<= 1u;
+            }
+
+            return rounded;
+        }
+    }
+
+    Coverage::Coverage(size_t size)
+        : _hits(round_up(size), byte_t(0))
+        , _touched()
+        , _mask(_hits.size() - 1)
+    {
+        // Reserving every entry up front keeps edges from allocating.
+        _touched.reserve(_hits.size());
+    }
+
+    bool Coverage::merge(std::atomic<byte_t>* shared) noexcept
+    {
+        auto fresh = false;
+
+        for (auto index : _touched)
+        {
+            auto bits = bucket(_hits[index]);
+            _hits[index] = 0;
+
+            // Checking before writing keeps the shared cache lines clean once coverage stabilizes.
+            auto& entry = shared[index];
+            if ((entry.load(std::memory_order_relaxed) & bits) != bits)
+            {
+                auto previous = entry.fetch_or(bits, std::memory_order_relaxed);
+                fresh = fresh || (previous & bits) != bits;
+            }
+        }
+
+        _touched.clear();
+
+        return fresh;
+    }
+
+    void Coverage::clear() noexcept
+    {
+        for (auto index : _touched)
+        {
+            _hits[index] = 0;
+        }
+
+        _touched.clear();
+    }
+}
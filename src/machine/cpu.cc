@@ -2,6 +2,26 @@
 
 namespace zasm
 {
+    CPU::CPU()
+        : _af()
+        , _bc()
+        , _de()
+        , _hl()
+        , _alternateAf()
+        , _alternateBc()
+        , _alternateDe()
+        , _alternateHl()
+        , _ir()
+        , _ix()
+        , _iy()
+        , _sp()
+        , _pc()
+        , _iff1(false)
+        , _iff2(false)
+        , _halted(false)
+    {
+    }
+
     word_t CPU::read(WordRegister r) const noexcept
     {
         switch (r)
@@ -37,6 +57,8 @@ namespace zasm
             case PC:
                 return _pc.word;
         }
+
+        return 0;
     }
 
     byte_t CPU::read(ByteRegister r) const noexcept
@@ -44,30 +66,32 @@ namespace zasm
         switch (r)
         {
             case A:
-                return _af.highByte;
+                return _af.highByte();
             case F:
-                return _af.lowByte;
+                return _af.lowByte();
 
             case B:
-                return _bc.highByte;
+                return _bc.highByte();
             case C:
-                return _bc.lowByte;
+                return _bc.lowByte();
 
             case D:
-                return _de.highByte;
+                return _de.highByte();
             case E:
-                return _de.lowByte;
+                return _de.lowByte();
 
             case H:
-                return _hl.highByte;
+                return _hl.highByte();
             case L:
-                return _hl.lowByte;
+                return _hl.lowByte();
 
             case I:
-                return _ir.highByte;
+                return _ir.highByte();
             case R:
-                return _ir.lowByte;
+                return _ir.lowByte();
         }
+
+        return 0;
     }
 
     void CPU::write(WordRegister r, word_t value) noexcept
@@ -125,38 +149,38 @@ namespace zasm
         switch (r)
         {
             case A:
-                _af.highByte = value;
+                _af.highByte(value);
                 break;
             case F:
-                _af.lowByte = value;
+                _af.lowByte(value);
                 break;
 
             case B:
-                _bc.highByte = value;
+                _bc.highByte(value);
                 break;
             case C:
-                _bc.lowByte = value;
+                _bc.lowByte(value);
                 break;
 
             case D:
-                _de.highByte = value;
+                _de.highByte(value);
                 break;
             case E:
-                _de.lowByte = value;
+                _de.lowByte(value);
                 break;
 
             case H:
-                _hl.highByte = value;
+                _hl.highByte(value);
                 break;
             case L:
-                _hl.lowByte = value;
+                _hl.lowByte(value);
                 break;
 
             case I:
-                _ir.highByte = value;
+                _ir.highByte(value);
                 break;
             case R:
-                _ir.lowByte = value;
+                _ir.lowByte(value);
                 break;
         }
     }
@@ -191,15 +215,21 @@ namespace zasm
         write<F>(0);
     }
 
+    void CPU::refresh(uint64_t fetches) noexcept
+    {
+        auto r = read<R>();
+        write<R>(byte_t((r & 0x80u) | ((r + fetches) & 0x7Fu)));
+    }
+
     void CPU::set(Flag flag, bool value) noexcept
     {
         if (value)
         {
-            disable(flag);
+            enable(flag);
         }
         else
         {
-            enable(flag);
+            disable(flag);
         }
     }
 }
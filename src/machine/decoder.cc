@@ -0,0 +1,251 @@
+#include "machine/decoder.hh"
+
+#include <string>
+
+namespace zasm
+{
+    namespace
+    {
+        /**
+         * The index of a byte register in the `r` field of an opcode.
+         */
+        constexpr byte_t index(ByteRegister r) noexcept
+        {
+            switch (r)
+            {
+                case B:
+                    return 0;
+                case C:
+                    return 1;
+                case D:
+                    return 2;
+                case E:
+                    return 3;
+                case H:
+                    return 4;
+                case L:
+                    return 5;
+                case A:
+                    return 7;
+                default:
+                    return 6;
+            }
+        }
+
+        std::string spelling(ByteRegister r)
+        {
+            static const char* const names[] = { "A", "F", "B", "C", "D", "E", "H", "L", "I", "R" };
+            return names[r];
+        }
+
+        std::string spelling(WordRegister rr)
+        {
+            static const char* const names[] = {
+                "AF", "BC", "DE", "HL", "AF_", "BC_", "DE_", "HL_", "IR", "IX", "IY", "SP", "PC",
+            };
+            return names[rr];
+        }
+
+        std::string spelling(Flag flag)
+        {
+            switch (flag)
+            {
+                case Flag::S:
+                    return "Flag::S";
+                case Flag::Z:
+                    return "Flag::Z";
+                case Flag::H:
+                    return "Flag::H";
+                case Flag::PV:
+                    return "Flag::PV";
+                case Flag::N:
+                    return "Flag::N";
+                default:
+                    return "Flag::C";
+            }
+        }
+
+        std::string spelling(bool value)
+        {
+            return value ? "true" : "false";
+        }
+
+        /**
+         * Spells a call to a handler with the given template arguments, leaving the remaining ones to their default.
+         */
+        template<auto... arguments>
+        std::string spell(const char* name)
+        {
+            std::string text;
+            ((text += text.empty() ? "" : ", ", text += spelling(arguments)), ...);
+
+            return name + ('<' + text + '>');
+        }
+
+/**
+ * Expands to a handler with the given template arguments, followed by its spelling, so that both come from one source.
+ */
+#define HANDLER(name, arguments) \
+    name<HANDLER_ARGUMENTS arguments>, spell<HANDLER_ARGUMENTS arguments>(#name)
+
+#define HANDLER_ARGUMENTS(...) \
+    __VA_ARGS__
+
+        template<ByteRegister r>
+        void decode_ld_R_R(OpcodeTable& table) noexcept
+        {
+            auto base = byte_t(0x40u | (index(r) << 3u));
+
+            table.set(base | index(B), HANDLER(ld_R_R, (r, B)), Flow::Next);
+            table.set(base | index(C), HANDLER(ld_R_R, (r, C)), Flow::Next);
+            table.set(base | index(D), HANDLER(ld_R_R, (r, D)), Flow::Next);
+            table.set(base | index(E), HANDLER(ld_R_R, (r, E)), Flow::Next);
+            table.set(base | index(H), HANDLER(ld_R_R, (r, H)), Flow::Next);
+            table.set(base | index(L), HANDLER(ld_R_R, (r, L)), Flow::Next);
+            table.set(base | index(A), HANDLER(ld_R_R, (r, A)), Flow::Next);
+        }
+
+        template<ByteRegister r>
+        void decode_ld_R(OpcodeTable& main, OpcodeTable& dd, OpcodeTable& fd) noexcept
+        {
+            auto shifted = byte_t(index(r) << 3u);
+
+            decode_ld_R_R<r>(main);
+            main.set(0x06u | shifted, HANDLER(ld_R_N, (r)), Flow::Next);
+            main.set(0x46u | shifted, HANDLER(ld_R_atRR, (r, HL)), Flow::Next);
+            main.set(0x70u | index(r), HANDLER(ld_atRR_R, (HL, r)), Flow::Next);
+
+            dd.set(0x46u | shifted, HANDLER(ld_R_atII_plusD, (r, IX)), Flow::Next);
+            fd.set(0x46u | shifted, HANDLER(ld_R_atII_plusD, (r, IY)), Flow::Next);
+        }
+    }
+
+    Opcode& OpcodeTable::set(byte_t byte, Instruction execute, std::string handler, Flow flow)
+    {
+        auto& opcode = opcodes[byte];
+        opcode.execute = std::move(execute);
+        opcode.flow = flow;
+        handlers[byte] = std::move(handler);
+
+        return opcode;
+    }
+
+    Decoder::Decoder()
+        : _main()
+        , _ed()
+        , _dd()
+        , _fd()
+    {
+        decode_ld_R<B>(_main, _dd, _fd);
+        decode_ld_R<C>(_main, _dd, _fd);
+        decode_ld_R<D>(_main, _dd, _fd);
+        decode_ld_R<E>(_main, _dd, _fd);
+        decode_ld_R<H>(_main, _dd, _fd);
+        decode_ld_R<L>(_main, _dd, _fd);
+        decode_ld_R<A>(_main, _dd, _fd);
+
+        _main.set(0x00, HANDLER(nop, ()), Flow::Next);
+        _main.set(0x76, HANDLER(halt, ()), Flow::Next);
+        _main.set(0xF3, HANDLER(di, ()), Flow::Next);
+        _main.set(0xFB, HANDLER(ei, ()), Flow::Next).delaysInterrupts = true;
+
+        _main.set(0xE6, HANDLER(and_N, ()), Flow::Next);
+
+        _main.set(0x0A, HANDLER(ld_R_atRR, (A, BC)), Flow::Next);
+        _main.set(0x1A, HANDLER(ld_R_atRR, (A, DE)), Flow::Next);
+        _main.set(0x02, HANDLER(ld_atRR_R, (BC, A)), Flow::Next);
+        _main.set(0x12, HANDLER(ld_atRR_R, (DE, A)), Flow::Next);
+        _main.set(0x36, HANDLER(ld_atRR_N, (HL)), Flow::Next);
+        _main.set(0x3A, HANDLER(ld_R_atNN, (A)), Flow::Next);
+        _main.set(0x32, HANDLER(ld_atNN_R, (A)), Flow::Next);
+
+        _main.set(0x01, HANDLER(ld_RR_NN, (BC)), Flow::Next);
+        _main.set(0x11, HANDLER(ld_RR_NN, (DE)), Flow::Next);
+        _main.set(0x21, HANDLER(ld_RR_NN, (HL)), Flow::Next);
+        _main.set(0x31, HANDLER(ld_RR_NN, (SP)), Flow::Next);
+
+        _main.set(0x03, HANDLER(inc_RR, (BC)), Flow::Next);
+        _main.set(0x13, HANDLER(inc_RR, (DE)), Flow::Next);
+        _main.set(0x23, HANDLER(inc_RR, (HL)), Flow::Next);
+        _main.set(0x33, HANDLER(inc_RR, (SP)), Flow::Next);
+
+        _main.set(0x0B, HANDLER(dec_RR, (BC)), Flow::Next);
+        _main.set(0x1B, HANDLER(dec_RR, (DE)), Flow::Next);
+        _main.set(0x2B, HANDLER(dec_RR, (HL)), Flow::Next);
+        _main.set(0x3B, HANDLER(dec_RR, (SP)), Flow::Next);
+
+        _main.set(0x10, HANDLER(djnz_E, ()), Flow::Jump);
+        _main.set(0x18, HANDLER(jr_E, ()), Flow::Jump);
+        _main.set(0x20, HANDLER(jr_CC_E, (Flag::Z, false)), Flow::Jump);
+        _main.set(0x28, HANDLER(jr_CC_E, (Flag::Z, true)), Flow::Jump);
+        _main.set(0x30, HANDLER(jr_CC_E, (Flag::C, false)), Flow::Jump);
+        _main.set(0x38, HANDLER(jr_CC_E, (Flag::C, true)), Flow::Jump);
+        _main.set(0xC3, HANDLER(jp_NN, ()), Flow::Jump);
+        _main.set(0xCD, HANDLER(call_NN, ()), Flow::Call);
+        _main.set(0xC9, HANDLER(ret, ()), Flow::Return);
+
+        _ed.set(0x57, HANDLER(ld_R_IR, (A, I)), Flow::Next);
+        _ed.set(0x5F, HANDLER(ld_R_IR, (A, R)), Flow::Next);
+
+        _dd.set(0x36, HANDLER(ld_atRR_plus_D_N, (IX)), Flow::Next);
+        _fd.set(0x36, HANDLER(ld_atRR_plus_D_N, (IY)), Flow::Next);
+
+        // Prefixed instructions fetch both their prefix and their opcode.
+        for (auto* table : { &_ed, &_dd, &_fd })
+        {
+            for (auto& opcode : table->opcodes)
+            {
+                opcode.fetches = 2;
+            }
+        }
+    }
+
+#undef HANDLER_ARGUMENTS
+#undef HANDLER
+
+    const Decoder& Decoder::instance() noexcept
+    {
+        static const Decoder decoder;
+        return decoder;
+    }
+
+    const Opcode* Decoder::decode(const Bus& bus, address_t address) const noexcept
+    {
+        auto byte = bus.read<byte_t>(address);
+
+        const Opcode* opcode;
+        switch (byte)
+        {
+            case 0xED:
+                opcode = &_ed.opcodes[bus.read<byte_t>(address + 1)];
+                break;
+            case 0xDD:
+                opcode = &_dd.opcodes[bus.read<byte_t>(address + 1)];
+                break;
+            case 0xFD:
+                opcode = &_fd.opcodes[bus.read<byte_t>(address + 1)];
+                break;
+            default:
+                opcode = &_main.opcodes[byte];
+                break;
+        }
+
+        return *opcode ? opcode : nullptr;
+    }
+
+    const std::string& Decoder::handler(const Opcode& opcode) const noexcept
+    {
+        static const std::string none;
+
+        for (const auto* table : { &_main, &_ed, &_dd, &_fd })
+        {
+            const auto* first = table->opcodes.data();
+            if (&opcode >= first && &opcode < first + table->opcodes.size())
+            {
+                return table->handlers[size_t(&opcode - first)];
+            }
+        }
+
+        return none;
+    }
+}
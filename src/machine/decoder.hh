@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef __ZASM__MACHINE__DECODER__
+#define __ZASM__MACHINE__DECODER__
+
+#include <array>
+#include <string>
+
+#include "zasm/machine/bus.hh"
+
+#include "machine/instructions.hh"
+
+namespace zasm
+{
+    /**
+     * How an instruction transfers control once executed.
+     */
+    enum class Flow
+    {
+        Next,
+        Jump,
+        Call,
+        Return,
+    };
+
+    /**
+     * An entry of the decoding tables.
+     */
+    struct Opcode
+    {
+        Instruction execute;
+        Flow flow = Flow::Next;
+
+        /**
+         * The number of opcode fetches of the instruction, each of them refreshing the R register.
+         */
+        byte_t fetches = 1;
+
+        /**
+         * Indicates if interrupts cannot be accepted right after the instruction, as is the case for `EI`.
+         */
+        bool delaysInterrupts = false;
+
+        /**
+         * Indicates if this entry holds an implemented instruction.
+         */
+        [[nodiscard]] inline explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(execute);
+        }
+    };
+
+    /**
+     * A table mapping a byte of an instruction to its implementation.
+     *
+     * The handlers are spelled apart from the opcodes, so that decoding never touches their spellings.
+     */
+    struct OpcodeTable
+    {
+        std::array<Opcode, 256> opcodes;
+
+        /**
+         * The name of the handler of each opcode along with its template arguments, for code calling it directly.
+         */
+        std::array<std::string, 256> handlers;
+
+        /**
+         * Sets the implementation of an opcode.
+         * @return The opcode, to set its remaining fields
+         */
+        Opcode& set(byte_t byte, Instruction execute, std::string handler, Flow flow);
+    };
+
+    /**
+     * Tables mapping the bytes of an instruction to its implementation.
+     */
+    class Decoder final
+    {
+    private:
+        OpcodeTable _main;
+        OpcodeTable _ed;
+        OpcodeTable _dd;
+        OpcodeTable _fd;
+
+        Decoder();
+
+    public:
+        /**
+         * Gets the decoder shared by every machine.
+         * @return The decoder
+         */
+        [[nodiscard]] static const Decoder& instance() noexcept;
+
+        /**
+         * Decodes the instruction starting at the given address.
+         * @param bus The bus from which to read the instruction
+         * @param address The address of the first byte of the instruction
+         * @return The decoded instruction, or `nullptr` if it is not implemented
+         */
+        [[nodiscard]] const Opcode* decode(const Bus& bus, address_t address) const noexcept;
+
+        /**
+         * Gets the name of the handler of a decoded opcode along with its template arguments, for code calling it
+         * directly.
+         * @param opcode An opcode returned by `decode`
+         * @return The spelling of its handler
+         */
+        [[nodiscard]] const std::string& handler(const Opcode& opcode) const noexcept;
+    };
+}
+
+#endif
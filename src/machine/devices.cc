@@ -0,0 +1,211 @@
+#include "zasm/machine/devices.hh"
+
+#include "meta.hh"
+
+#include <exception>
+
+namespace zasm
+{
+    /**
+     * A bus component resuming the devices waiting for a write to its address.
+     */
+    class Devices::Port final : public BusComponent
+    {
+    private:
+        struct Waiter
+        {
+            std::coroutine_handle<> handle;
+            byte_t* value;
+        };
+
+        Devices* _devices;
+        address_t _address;
+        std::vector<Waiter> _waiters;
+
+    public:
+        Port(Devices& devices, address_t address)
+            : _devices(&devices)
+            , _address(address)
+            , _waiters()
+        {
+        }
+
+        void wait(std::coroutine_handle<> handle, byte_t* value)
+        {
+            _waiters.push_back({ handle, value });
+        }
+
+        /**
+         * Ignores the writes made from now on, as the bus keeps its components after the devices are destroyed.
+         */
+        void disable() noexcept
+        {
+            _devices = nullptr;
+            _waiters.clear();
+        }
+
+        [[nodiscard]] byte_t read(address_t address) const noexcept override
+        {
+            UNUSED(address);
+            return 0;
+        }
+
+        void write(address_t address, byte_t byte) noexcept override
+        {
+            UNUSED(address);
+
+            if (_devices == nullptr)
+            {
+                return;
+            }
+
+            // Writes happen within instructions, so the devices are resumed once the instruction completes.
+            for (const auto& waiter : _waiters)
+            {
+                *waiter.value = byte;
+                _devices->resume(_devices->_machine.cycles(), waiter.handle);
+            }
+            _waiters.clear();
+        }
+
+        [[nodiscard]] bool accept_write(address_t address) const noexcept override
+        {
+            return address == _address;
+        }
+    };
+
+    Task Task::promise_type::get_return_object() noexcept
+    {
+        return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    void Task::promise_type::unhandled_exception() noexcept
+    {
+        std::terminate();
+    }
+
+    Task::Task(std::coroutine_handle<promise_type> handle) noexcept
+        : _handle(handle)
+    {
+    }
+
+    Task::Task(Task&& other) noexcept
+        : _handle(std::exchange(other._handle, nullptr))
+    {
+    }
+
+    Task::~Task()
+    {
+        if (_handle)
+        {
+            _handle.destroy();
+        }
+    }
+
+    Devices::Delay::Delay(Devices& devices, uint64_t cycles) noexcept
+        : _devices(devices)
+        , _cycles(cycles)
+    {
+    }
+
+    bool Devices::Delay::await_ready() const noexcept
+    {
+        return _cycles == 0;
+    }
+
+    void Devices::Delay::await_suspend(std::coroutine_handle<> handle)
+    {
+        _devices.resume(_devices._now + _cycles, handle);
+    }
+
+    Devices::Write::Write(Devices& devices, address_t port) noexcept
+        : _devices(devices)
+        , _port(port)
+        , _value(0)
+    {
+    }
+
+    void Devices::Write::await_suspend(std::coroutine_handle<> handle)
+    {
+        auto& port = _devices._ports[_port];
+        if (port == nullptr)
+        {
+            port = &_devices._machine.bus().attach<Port>(_devices, _port);
+        }
+
+        port->wait(handle, &_value);
+    }
+
+    Devices::Acknowledge::Acknowledge(Devices& devices) noexcept
+        : _devices(devices)
+    {
+    }
+
+    void Devices::Acknowledge::await_suspend(std::coroutine_handle<> handle)
+    {
+        _devices._acknowledging.push_back(handle);
+    }
+
+    Devices::Devices(Machine& machine)
+        : _machine(machine)
+        , _now(machine.cycles())
+        , _tasks()
+        , _ports()
+        , _acknowledging()
+        , _listener(0)
+        , _alive(std::make_shared<bool>(true))
+    {
+        _listener = _machine.on_acknowledge([this]() {
+            acknowledge();
+        });
+    }
+
+    Devices::~Devices()
+    {
+        _machine.remove_acknowledge(_listener);
+
+        for (auto& [address, port] : _ports)
+        {
+            port->disable();
+        }
+
+        _alive.reset();
+
+        for (auto task : _tasks)
+        {
+            task.destroy();
+        }
+    }
+
+    void Devices::spawn(Task task)
+    {
+        auto handle = std::exchange(task._handle, nullptr);
+
+        _tasks.push_back(handle);
+        resume(_machine.cycles(), handle);
+    }
+
+    void Devices::resume(uint64_t cycle, std::coroutine_handle<> handle)
+    {
+        std::weak_ptr<bool> alive = _alive;
+
+        _machine.scheduler().schedule(cycle, [this, alive, cycle, handle]() {
+            if (alive.expired())
+            {
+                return;
+            }
+
+            _now = cycle;
+            handle.resume();
+        });
+    }
+
+    void Devices::acknowledge()
+    {
+        for (auto handle : _acknowledging)
+        {
+            resume(_machine.cycles(), handle);
+        }
+        _acknowledging.clear();
+    }
+}
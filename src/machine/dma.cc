@@ -0,0 +1,98 @@
+#include "zasm/machine/dma.hh"
+
+#include "meta.hh"
+
+#include <algorithm>
+
+namespace zasm
+{
+    namespace
+    {
+        constexpr size_t REGISTERS = DMA::CONTROL + 1;
+    }
+
+    DMA::DMA(Bus& bus, address_t address)
+        : _bus(bus)
+        , _address(address)
+        , _registers()
+        , _buffer(ADDRESS_SPACE, byte_t(0))
+        , _busy(false)
+    {
+    }
+
+    void DMA::transfer(address_t source, address_t destination, size_t length) noexcept
+    {
+        // Writing the control register from within a transfer would start over with a buffer still being written.
+        if (_busy)
+        {
+            return;
+        }
+
+        length = std::min(length, ADDRESS_SPACE);
+
+        _busy = true;
+        _bus.read_span(source, _buffer.data(), length);
+        _bus.write_span(destination, _buffer.data(), length);
+        _busy = false;
+    }
+
+    byte_t DMA::read(address_t address) const noexcept
+    {
+        auto offset = size_t(address_t(address - _address));
+        return offset < _registers.size() ? _registers[offset] : 0;
+    }
+
+    void DMA::write(address_t address, byte_t byte) noexcept
+    {
+        auto offset = size_t(address_t(address - _address));
+
+        if (offset < _registers.size())
+        {
+            _registers[offset] = byte;
+            return;
+        }
+
+        if (byte != 1)
+        {
+            return;
+        }
+
+        auto word = [this](size_t offset) {
+            return word_t(_registers[offset] | (_registers[offset + 1] << 8u));
+        };
+
+        auto length = word(LENGTH);
+        transfer(word(SOURCE), word(DESTINATION), length == 0 ? ADDRESS_SPACE : length);
+    }
+
+    bool DMA::accept_read(address_t address) const noexcept
+    {
+        return address >= _address && address < size_t(_address) + REGISTERS;
+    }
+
+    bool DMA::accept_write(address_t address) const noexcept
+    {
+        return accept_read(address);
+    }
+
+    bool DMA::idempotent(address_t address) const noexcept
+    {
+        UNUSED(address);
+        return true;
+    }
+
+    size_t DMA::extent(address_t address) const noexcept
+    {
+        if (address < _address)
+        {
+            return _address - address;
+        }
+
+        if (address < size_t(_address) + REGISTERS)
+        {
+            return size_t(_address) + REGISTERS - address;
+        }
+
+        return ADDRESS_SPACE - address;
+    }
+}
@@ -0,0 +1,338 @@
+#include "zasm/machine/image.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ZASM_IMAGE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace zasm
+{
+    namespace
+    {
+        constexpr char MAGIC[8] = { 'Z', 'A', 'S', 'M', 'I', 'M', 'G', '\0' };
+
+        constexpr uint32_t HEADER_SIZE = 64;
+        constexpr uint32_t CPU_OFFSET = 32;
+        constexpr uint32_t ENTRY_SIZE = 32;
+
+        constexpr size_t WORD_REGISTERS = size_t(PC) + 1;
+        constexpr size_t FLAGS_OFFSET = CPU_OFFSET + 2 * WORD_REGISTERS;
+
+        template<typename T>
+        void put(byte_t* bytes, T value) noexcept
+        {
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                bytes[i] = byte_t(uint64_t(value) >> (8 * i));
+            }
+        }
+
+        template<typename T>
+        [[nodiscard]] T get(const byte_t* bytes) noexcept
+        {
+            uint64_t value = 0;
+
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                value |= uint64_t(bytes[i]) << (8 * i);
+            }
+
+            return T(value);
+        }
+
+        [[nodiscard]] uint64_t align(uint64_t offset) noexcept
+        {
+            return (offset + Image::SECTION_ALIGNMENT - 1) / Image::SECTION_ALIGNMENT * Image::SECTION_ALIGNMENT;
+        }
+
+        [[nodiscard]] std::shared_ptr<byte_t> allocate(size_t size)
+        {
+            return std::shared_ptr<byte_t>(new byte_t[std::max<size_t>(size, 1)](), std::default_delete<byte_t[]>());
+        }
+
+        void read(std::ifstream& input, uint64_t offset, byte_t* bytes, size_t size)
+        {
+            input.seekg(std::streamoff(offset));
+            input.read(reinterpret_cast<char*>(bytes), std::streamsize(size));
+
+            if (!input)
+            {
+                throw ImageError("truncated image");
+            }
+        }
+    }
+
+#if ZASM_IMAGE_MMAP
+    namespace
+    {
+        /**
+         * Indicates if sections aligned on the given alignment can be mapped.
+         */
+        [[nodiscard]] bool mappable(uint32_t alignment) noexcept
+        {
+            auto page = ::sysconf(_SC_PAGESIZE);
+            return page > 0 && alignment % uint64_t(page) == 0;
+        }
+
+        /**
+         * Maps a memory section read-only, the mapping outliving the descriptor.
+         */
+        [[nodiscard]] std::shared_ptr<byte_t> map(int descriptor, uint64_t offset, size_t size)
+        {
+            if (size == 0)
+            {
+                return allocate(size);
+            }
+
+            auto* memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, off_t(offset));
+            if (memory == MAP_FAILED)
+            {
+                throw ImageError("cannot map a memory section");
+            }
+
+            return std::shared_ptr<byte_t>(static_cast<byte_t*>(memory), [size](byte_t* bytes) {
+                ::munmap(bytes, size);
+            });
+        }
+    }
+#endif
+
+    Image::Image()
+        : _cpu()
+        , _interrupt(false)
+        , _deferred(false)
+        , _sections()
+    {
+    }
+
+    Image Image::open(const std::string& path)
+    {
+        std::ifstream input(path, std::ios::binary | std::ios::ate);
+        if (!input)
+        {
+            throw ImageError("cannot open " + path);
+        }
+
+        auto fileSize = uint64_t(input.tellg());
+
+        std::vector<byte_t> header(HEADER_SIZE);
+        if (fileSize < HEADER_SIZE)
+        {
+            throw ImageError("truncated image");
+        }
+        read(input, 0, header.data(), header.size());
+
+        if (std::memcmp(header.data(), MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw ImageError("not a machine image");
+        }
+
+        auto major = get<uint16_t>(&header[8]);
+        if (major != MAJOR_VERSION)
+        {
+            throw ImageError("unsupported image version " + std::to_string(major));
+        }
+
+        auto headerSize = get<uint32_t>(&header[12]);
+        auto alignment = get<uint32_t>(&header[16]);
+        auto count = get<uint32_t>(&header[20]);
+        auto entrySize = get<uint32_t>(&header[24]);
+
+        if (headerSize < HEADER_SIZE || entrySize < ENTRY_SIZE || alignment == 0
+            || headerSize + uint64_t(count) * entrySize > fileSize)
+        {
+            throw ImageError("malformed image header");
+        }
+
+        Image image;
+
+        for (size_t r = 0; r < WORD_REGISTERS; ++r)
+        {
+            image._cpu.write(WordRegister(r), get<word_t>(&header[CPU_OFFSET + 2 * r]));
+        }
+
+        image._cpu.iff1() = header[FLAGS_OFFSET] != 0;
+        image._cpu.iff2() = header[FLAGS_OFFSET + 1] != 0;
+        image._cpu.halted() = header[FLAGS_OFFSET + 2] != 0;
+        image._interrupt = header[FLAGS_OFFSET + 3] != 0;
+        image._deferred = header[FLAGS_OFFSET + 4] != 0;
+
+        std::vector<byte_t> table(size_t(count) * entrySize);
+        read(input, headerSize, table.data(), table.size());
+
+        image._sections.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto* entry = &table[i * entrySize];
+
+            auto kind = Kind(get<uint32_t>(entry));
+            auto start = get<uint32_t>(entry + 4);
+            auto end = get<uint32_t>(entry + 8);
+            auto offset = get<uint64_t>(entry + 16);
+            auto size = get<uint64_t>(entry + 24);
+
+            if (kind != Kind::RAM && kind != Kind::ROM)
+            {
+                throw ImageError("unknown component kind " + std::to_string(uint32_t(kind)));
+            }
+
+            if (start > end || end > ADDRESS_SPACE || size != end - start || offset % alignment != 0
+                || offset > fileSize || size > fileSize - offset)
+            {
+                throw ImageError("malformed component entry");
+            }
+
+            image._sections.push_back(Section{ kind, address_t(start), end, offset, nullptr });
+        }
+
+#if ZASM_IMAGE_MMAP
+        if (mappable(alignment))
+        {
+            auto descriptor = ::open(path.c_str(), O_RDONLY);
+            if (descriptor < 0)
+            {
+                throw ImageError("cannot open " + path);
+            }
+
+            try
+            {
+                for (auto& section : image._sections)
+                {
+                    section.memory = map(descriptor, section.offset, section.end - section.start);
+                }
+            }
+            catch (...)
+            {
+                ::close(descriptor);
+                throw;
+            }
+
+            ::close(descriptor);
+            return image;
+        }
+#endif
+
+        for (auto& section : image._sections)
+        {
+            auto size = section.end - section.start;
+            section.memory = allocate(size);
+            read(input, section.offset, section.memory.get(), size);
+        }
+
+        return image;
+    }
+
+    void Image::save(const Machine& machine, const std::string& path)
+    {
+        std::vector<const RAM*> memories;
+        std::vector<Kind> kinds;
+
+        for (const auto& component : machine.bus().components())
+        {
+            if (dynamic_cast<const ROM*>(component.get()) != nullptr)
+            {
+                kinds.push_back(Kind::ROM);
+            }
+            else if (dynamic_cast<const RAM*>(component.get()) != nullptr)
+            {
+                kinds.push_back(Kind::RAM);
+            }
+            else
+            {
+                continue;
+            }
+
+            memories.push_back(static_cast<const RAM*>(component.get()));
+        }
+
+        std::vector<byte_t> header(HEADER_SIZE + memories.size() * ENTRY_SIZE, byte_t(0));
+
+        std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+        put<uint16_t>(&header[8], MAJOR_VERSION);
+        put<uint16_t>(&header[10], MINOR_VERSION);
+        put<uint32_t>(&header[12], HEADER_SIZE);
+        put<uint32_t>(&header[16], SECTION_ALIGNMENT);
+        put<uint32_t>(&header[20], uint32_t(memories.size()));
+        put<uint32_t>(&header[24], ENTRY_SIZE);
+
+        const auto& cpu = machine.cpu();
+        for (size_t r = 0; r < WORD_REGISTERS; ++r)
+        {
+            put<word_t>(&header[CPU_OFFSET + 2 * r], cpu.read(WordRegister(r)));
+        }
+
+        header[FLAGS_OFFSET] = cpu.iff1();
+        header[FLAGS_OFFSET + 1] = cpu.iff2();
+        header[FLAGS_OFFSET + 2] = cpu.halted();
+        header[FLAGS_OFFSET + 3] = machine._interrupt;
+        header[FLAGS_OFFSET + 4] = machine._deferred;
+
+        std::vector<uint64_t> offsets;
+        auto offset = align(header.size());
+
+        for (size_t i = 0; i < memories.size(); ++i)
+        {
+            auto size = uint64_t(memories[i]->end() - memories[i]->start());
+            auto* entry = &header[HEADER_SIZE + i * ENTRY_SIZE];
+
+            put<uint32_t>(entry, uint32_t(kinds[i]));
+            put<uint32_t>(entry + 4, memories[i]->start());
+            put<uint32_t>(entry + 8, uint32_t(memories[i]->end()));
+            put<uint64_t>(entry + 16, offset);
+            put<uint64_t>(entry + 24, size);
+
+            offsets.push_back(offset);
+            offset = align(offset + size);
+        }
+
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char*>(header.data()), std::streamsize(header.size()));
+
+        std::vector<char> padding(SECTION_ALIGNMENT, 0);
+        auto position = uint64_t(header.size());
+
+        for (size_t i = 0; i < memories.size(); ++i)
+        {
+            auto size = memories[i]->end() - memories[i]->start();
+
+            output.write(padding.data(), std::streamsize(offsets[i] - position));
+            output.write(reinterpret_cast<const char*>(memories[i]->data()), std::streamsize(size));
+            position = offsets[i] + size;
+        }
+
+        if (!output)
+        {
+            throw ImageError("cannot write " + path);
+        }
+    }
+
+    void Image::start(Machine& machine) const
+    {
+        machine._cpu = _cpu;
+        machine._interrupt = _interrupt;
+        machine._deferred = _deferred;
+
+        for (const auto& section : _sections)
+        {
+            auto size = section.end - section.start;
+
+            auto memory = allocate(size);
+            std::memcpy(memory.get(), section.memory.get(), size);
+
+            if (section.kind == Kind::ROM)
+            {
+                machine.bus().attach<ROM>(section.start, section.end, std::move(memory));
+            }
+            else
+            {
+                machine.bus().attach<RAM>(section.start, section.end, std::move(memory));
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include "zasm/machine/input.hh"
+
+#include "meta.hh"
+
+#include <algorithm>
+
+namespace zasm
+{
+    InputDevice::InputDevice(address_t address)
+        : _address(address)
+        , _input()
+        , _position(0)
+    {
+    }
+
+    void InputDevice::feed(const byte_t* data, size_t size)
+    {
+        _input.assign(data, data + size);
+        _position = 0;
+    }
+
+    void InputDevice::append(byte_t byte)
+    {
+        _input.push_back(byte);
+    }
+
+    byte_t InputDevice::read(address_t address) const noexcept
+    {
+        auto remaining = _position < _input.size();
+
+        if (address != _address)
+        {
+            return remaining ? 1 : 0;
+        }
+
+        return remaining ? _input[_position++] : 0;
+    }
+
+    void InputDevice::write(address_t address, byte_t byte) noexcept
+    {
+        UNUSED(address);
+        UNUSED(byte);
+    }
+
+    bool InputDevice::accept_read(address_t address) const noexcept
+    {
+        return address == _address || address == address_t(_address + 1);
+    }
+
+    bool InputDevice::idempotent(address_t address) const noexcept
+    {
+        return address != _address;
+    }
+
+    size_t InputDevice::extent(address_t address) const noexcept
+    {
+        // The status register wraps around to address 0 when the data register is the last address.
+        auto status = address_t(_address + 1);
+
+        if (address == _address)
+        {
+            return status == 0 ? 1 : 2;
+        }
+
+        if (address == status)
+        {
+            return 1;
+        }
+
+        auto next = ADDRESS_SPACE;
+        for (size_t bound : { size_t(_address), size_t(status) })
+        {
+            if (bound > address)
+            {
+                next = std::min(next, bound);
+            }
+        }
+
+        return next - address;
+    }
+
+    void InputDevice::restore() noexcept
+    {
+        _position = 0;
+    }
+}
@@ -150,6 +150,193 @@ namespace zasm
 
         return cycles;
     }
+
+    template<WordRegister rr, size_t cycles = 3>
+    size_t ld_RR_NN(CPU& cpu, Bus& bus) noexcept
+    {
+        auto pc = cpu.step(3);
+
+        auto nn = bus.read<word_t>(pc + 1);
+        cpu.write(rr, nn);
+
+        return cycles;
+    }
+
+    template<WordRegister rr, size_t cycles = 1>
+    size_t inc_RR(CPU& cpu, Bus& bus) noexcept
+    {
+        UNUSED(bus);
+        cpu.step();
+
+        cpu.write(rr, word_t(cpu.read(rr) + 1));
+
+        return cycles;
+    }
+
+    template<WordRegister rr, size_t cycles = 1>
+    size_t dec_RR(CPU& cpu, Bus& bus) noexcept
+    {
+        UNUSED(bus);
+        cpu.step();
+
+        cpu.write(rr, word_t(cpu.read(rr) - 1));
+
+        return cycles;
+    }
+
+    template<size_t cycles = 1>
+    size_t nop(CPU& cpu, Bus& bus) noexcept
+    {
+        UNUSED(bus);
+        cpu.step();
+
+        return cycles;
+    }
+
+    template<size_t cycles = 1>
+    size_t halt(CPU& cpu, Bus& bus) noexcept
+    {
+        UNUSED(bus);
+        cpu.step();
+
+        cpu.halted() = true;
+
+        return cycles;
+    }
+
+    template<size_t cycles = 1>
+    size_t di(CPU& cpu, Bus& bus) noexcept
+    {
+        UNUSED(bus);
+        cpu.step();
+
+        cpu.iff1() = false;
+        cpu.iff2() = false;
+
+        return cycles;
+    }
+
+    template<size_t cycles = 1>
+    size_t ei(CPU& cpu, Bus& bus) noexcept
+    {
+        UNUSED(bus);
+        cpu.step();
+
+        cpu.iff1() = true;
+        cpu.iff2() = true;
+
+        return cycles;
+    }
+
+    inline void and_flags(CPU& cpu, byte_t a) noexcept
+    {
+        auto parity = a;
+        parity ^= byte_t(parity >> 4u);
+        parity ^= byte_t(parity >> 2u);
+        parity ^= byte_t(parity >> 1u);
+
+        // S and the undocumented bits 5 and 3 are copied from the result.
+        cpu.write(F, byte_t(a & 0b10101000));
+        cpu.set(Flag::Z, a == 0);
+        cpu.enable(Flag::H);
+        cpu.set(Flag::PV, (parity & 1u) == 0);
+    }
+
+    template<size_t cycles = 2>
+    size_t and_N(CPU& cpu, Bus& bus) noexcept
+    {
+        auto pc = cpu.step(2);
+
+        auto a = byte_t(cpu.read(A) & bus.read<byte_t>(pc + 1));
+        cpu.write(A, a);
+        and_flags(cpu, a);
+
+        return cycles;
+    }
+
+    template<size_t cycles = 3>
+    size_t jr_E(CPU& cpu, Bus& bus) noexcept
+    {
+        auto pc = cpu.step(2);
+
+        auto e = int8_t(bus.read<byte_t>(pc + 1));
+        cpu.write(PC, address_t(cpu.read(PC) + e));
+
+        return cycles;
+    }
+
+    template<Flag flag, bool value, size_t taken = 3, size_t notTaken = 2>
+    size_t jr_CC_E(CPU& cpu, Bus& bus) noexcept
+    {
+        auto pc = cpu.step(2);
+
+        if (cpu.get(flag) != value)
+        {
+            return notTaken;
+        }
+
+        auto e = int8_t(bus.read<byte_t>(pc + 1));
+        cpu.write(PC, address_t(cpu.read(PC) + e));
+
+        return taken;
+    }
+
+    template<size_t cycles = 3>
+    size_t jp_NN(CPU& cpu, Bus& bus) noexcept
+    {
+        auto pc = cpu.step(3);
+
+        auto nn = bus.read<word_t>(pc + 1);
+        cpu.write(PC, nn);
+
+        return cycles;
+    }
+
+    template<size_t taken = 3, size_t notTaken = 2>
+    size_t djnz_E(CPU& cpu, Bus& bus) noexcept
+    {
+        auto pc = cpu.step(2);
+
+        auto b = byte_t(cpu.read(B) - 1);
+        cpu.write(B, b);
+
+        if (b == 0)
+        {
+            return notTaken;
+        }
+
+        auto e = int8_t(bus.read<byte_t>(pc + 1));
+        cpu.write(PC, address_t(cpu.read(PC) + e));
+
+        return taken;
+    }
+
+    template<size_t cycles = 5>
+    size_t call_NN(CPU& cpu, Bus& bus) noexcept
+    {
+        auto pc = cpu.step(3);
+
+        auto nn = bus.read<word_t>(pc + 1);
+
+        auto sp = address_t(cpu.read(SP) - 2);
+        cpu.write(SP, sp);
+        bus.write(sp, cpu.read(PC));
+
+        cpu.write(PC, nn);
+
+        return cycles;
+    }
+
+    template<size_t cycles = 3>
+    size_t ret(CPU& cpu, Bus& bus) noexcept
+    {
+        auto sp = cpu.read(SP);
+
+        cpu.write(PC, bus.read<word_t>(sp));
+        cpu.write(SP, sp + 2);
+
+        return cycles;
+    }
 }
 
 #endif
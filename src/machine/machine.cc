@@ -0,0 +1,452 @@
+#include "zasm/machine/machine.hh"
+
+#include "zasm/machine/compiled.hh"
+#include "zasm/machine/coverage.hh"
+#include "zasm/machine/profiler.hh"
+
+#include "machine/decoder.hh"
+#include "machine/instructions.hh"
+
+#include <algorithm>
+#include <chrono>
+
+namespace zasm
+{
+    namespace
+    {
+        /**
+         * The vector called when accepting an interrupt in interrupt mode 1.
+         */
+        constexpr address_t INTERRUPT_VECTOR = 0x0038;
+
+        constexpr size_t INTERRUPT_CYCLES = 3;
+
+        /**
+         * The shape of an iteration of a polling loop, `ld a,(nn) / and n / jr cc,loop`, that can be skipped, along
+         * with the cycles of each of its instructions.
+         */
+        constexpr address_t SPIN_LENGTH = 7;
+        constexpr uint64_t SPIN_LOAD_CYCLES = 4;
+        constexpr uint64_t SPIN_AND_CYCLES = 2;
+        constexpr uint64_t SPIN_JUMP_CYCLES = 3;
+        constexpr uint64_t SPIN_CYCLES = SPIN_LOAD_CYCLES + SPIN_AND_CYCLES + SPIN_JUMP_CYCLES;
+        constexpr uint64_t SPIN_INSTRUCTIONS = 3;
+
+        /**
+         * Indicates if a range of addresses is only served by ROM components, so that nothing written to the bus can
+         * change what it holds.
+         */
+        [[nodiscard]] bool read_only(const Bus& bus, address_t start, size_t end) noexcept
+        {
+            for (auto address = size_t(start); address < end; ++address)
+            {
+                auto served = false;
+
+                for (const auto& component : bus.components())
+                {
+                    if (!component->accept_read(address_t(address)) && !component->accept_write(address_t(address)))
+                    {
+                        continue;
+                    }
+
+                    if (dynamic_cast<const ROM*>(component.get()) == nullptr)
+                    {
+                        return false;
+                    }
+
+                    served = true;
+                }
+
+                if (!served)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    Machine::Machine()
+        : _cpu()
+        , _bus()
+        , _scheduler()
+        , _interrupt(false)
+        , _deferred(false)
+        , _acknowledgeListeners()
+        , _cycles(0)
+        , _instructions(0)
+        , _nanoseconds(0)
+        , _publishedInstructions(0)
+        , _publishedCycles(0)
+        , _publishedNanoseconds(0)
+        , _publishedAccesses()
+        , _profiler(nullptr)
+        , _coverage(nullptr)
+        , _compiled(nullptr)
+        , _compiledCycles(nullptr)
+        , _snapshot()
+        , _snapshotInterrupt(false)
+        , _snapshotDeferred(false)
+    {
+    }
+
+    Metrics Machine::metrics() const
+    {
+        Metrics metrics;
+        metrics.instructions = _instructions;
+        metrics.cycles = _cycles;
+        metrics.nanoseconds = _nanoseconds;
+        metrics.components = _bus.metrics();
+
+        for (const auto& component : metrics.components)
+        {
+            metrics.reads += component.reads;
+            metrics.writes += component.writes;
+            metrics.spans += component.spans;
+        }
+
+        return metrics;
+    }
+
+    void Machine::attach(Profiler* profiler) noexcept
+    {
+        _profiler = profiler;
+    }
+
+    void Machine::attach(Coverage* coverage) noexcept
+    {
+        _coverage = coverage;
+    }
+
+    bool Machine::attach(const CompiledCode* code)
+    {
+        if (code != nullptr && (!read_only(_bus, code->start, code->end) || !code->matches(_bus)))
+        {
+            return false;
+        }
+
+        _compiled = code;
+        return true;
+    }
+
+    size_t Machine::on_acknowledge(std::function<void()> listener)
+    {
+        _acknowledgeListeners.push_back(std::move(listener));
+        return _acknowledgeListeners.size() - 1;
+    }
+
+    void Machine::remove_acknowledge(size_t identifier) noexcept
+    {
+        // Leaves an empty slot, so that the identifiers of the other listeners stay valid.
+        _acknowledgeListeners[identifier] = nullptr;
+    }
+
+    void Machine::snapshot()
+    {
+        _snapshot = _cpu;
+        _snapshotInterrupt = _interrupt;
+        _snapshotDeferred = _deferred;
+        _bus.snapshot();
+    }
+
+    void Machine::restore() noexcept
+    {
+        _cpu = _snapshot;
+        _interrupt = _snapshotInterrupt;
+        _deferred = _snapshotDeferred;
+        _bus.restore();
+    }
+
+    size_t Machine::step()
+    {
+        if (_cycles >= _scheduler.next())
+        {
+            _scheduler.fire(_cycles);
+        }
+
+        if (_interrupt && _cpu.iff1() && !_deferred)
+        {
+            return acknowledge();
+        }
+
+        auto pc = _cpu.read(PC);
+
+        if (_cpu.halted())
+        {
+            _cpu.refresh();
+            _cycles += 1;
+            _instructions += 1;
+
+            if (_profiler != nullptr)
+            {
+                _profiler->retire(address_t(pc - 1), 1);
+            }
+
+            return 1;
+        }
+
+        const auto* opcode = Decoder::instance().decode(_bus, pc);
+        if (opcode == nullptr)
+        {
+            return 0;
+        }
+
+        // R is refreshed by the opcode fetches, before the instruction can read it.
+        _cpu.refresh(opcode->fetches);
+        auto cycles = opcode->execute(_cpu, _bus);
+        _deferred = opcode->delaysInterrupts;
+
+        _cycles += cycles;
+        _instructions += 1;
+
+        if (_coverage != nullptr && opcode->flow != Flow::Next)
+        {
+            _coverage->edge(pc, _cpu.read(PC));
+        }
+
+        if (_profiler != nullptr)
+        {
+            _profiler->retire(pc, cycles);
+
+            switch (opcode->flow)
+            {
+                case Flow::Call:
+                    _profiler->call(_cpu.read(PC));
+                    break;
+                case Flow::Return:
+                    _profiler->ret();
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        return cycles;
+    }
+
+    uint64_t Machine::run(uint64_t cycles)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto first = _cycles;
+        auto until = _cycles + cycles;
+
+        while (_cycles < until)
+        {
+            if (_cpu.halted() && !(_interrupt && _cpu.iff1()))
+            {
+                idle(until);
+                if (_cycles >= until)
+                {
+                    break;
+                }
+            }
+
+            if (_compiled != nullptr && execute(until))
+            {
+                continue;
+            }
+
+            auto pc = _cpu.read(PC);
+
+            auto taken = step();
+            if (taken == 0)
+            {
+                break;
+            }
+
+            if (_cpu.read(PC) == address_t(pc + 2 - SPIN_LENGTH))
+            {
+                spin(until);
+            }
+        }
+
+        auto elapsed = _cycles - first;
+
+        auto duration = std::chrono::steady_clock::now() - start;
+        _nanoseconds += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+
+        // Publishing happens once per run, which may be very short, so it only sums the counters of the bus.
+        ComponentMetrics accesses;
+        for (const auto& component : _bus.metrics())
+        {
+            accesses.reads += component.reads;
+            accesses.writes += component.writes;
+            accesses.spans += component.spans;
+        }
+
+        Metrics delta;
+        delta.instructions = _instructions - _publishedInstructions;
+        delta.cycles = _cycles - _publishedCycles;
+        delta.nanoseconds = _nanoseconds - _publishedNanoseconds;
+        delta.reads = accesses.reads - _publishedAccesses.reads;
+        delta.writes = accesses.writes - _publishedAccesses.writes;
+        delta.spans = accesses.spans - _publishedAccesses.spans;
+        Metrics::publish(delta);
+
+        _publishedInstructions = _instructions;
+        _publishedCycles = _cycles;
+        _publishedNanoseconds = _nanoseconds;
+        _publishedAccesses = accesses;
+
+        return elapsed;
+    }
+
+    size_t Machine::acknowledge()
+    {
+        auto pc = _cpu.read(PC);
+
+        _interrupt = false;
+        _cpu.halted() = false;
+        _cpu.iff1() = false;
+        _cpu.iff2() = false;
+        _cpu.refresh();
+
+        auto sp = address_t(_cpu.read(SP) - 2);
+        _cpu.write(SP, sp);
+        _bus.write(sp, pc);
+        _cpu.write(PC, INTERRUPT_VECTOR);
+
+        _cycles += INTERRUPT_CYCLES;
+
+        if (_coverage != nullptr)
+        {
+            _coverage->edge(pc, INTERRUPT_VECTOR);
+        }
+
+        if (_profiler != nullptr)
+        {
+            _profiler->call(INTERRUPT_VECTOR);
+            _profiler->retire(INTERRUPT_VECTOR, INTERRUPT_CYCLES);
+        }
+
+        for (const auto& listener : _acknowledgeListeners)
+        {
+            if (listener)
+            {
+                listener();
+            }
+        }
+
+        return INTERRUPT_CYCLES;
+    }
+
+    void Machine::idle(uint64_t until)
+    {
+        // Halted cycles only fetch from the bus and refresh memory until an event can change anything.
+        until = std::min(until, _scheduler.next());
+        if (until <= _cycles)
+        {
+            return;
+        }
+
+        auto skipped = until - _cycles;
+        _cpu.refresh(skipped);
+        _cycles += skipped;
+        _instructions += skipped;
+
+        if (_profiler != nullptr)
+        {
+            _profiler->retire(address_t(_cpu.read(PC) - 1), skipped);
+        }
+    }
+
+    void Machine::spin(uint64_t until)
+    {
+        auto loop = _cpu.read(PC);
+
+        // Looking for the loop must not disturb devices mapped where the code is.
+        for (address_t offset = 0; offset < SPIN_LENGTH; ++offset)
+        {
+            if (!_bus.idempotent(address_t(loop + offset)))
+            {
+                return;
+            }
+        }
+
+        auto byte = [this, loop](address_t offset) {
+            return _bus.peek(address_t(loop + offset));
+        };
+
+        auto jump = byte(5);
+        if (byte(0) != 0x3A || byte(3) != 0xE6 || (jump != 0x20 && jump != 0x28) || byte(6) != byte_t(-SPIN_LENGTH))
+        {
+            return;
+        }
+
+        auto polled = address_t(byte(1) | (byte(2) << 8u));
+        if (!_bus.idempotent(polled) || (_interrupt && _cpu.iff1()))
+        {
+            return;
+        }
+
+        // An event may have changed the polled byte after it was loaded, so the next iteration must be checked too.
+        auto value = byte_t(_bus.peek(polled) & byte(4));
+        if ((value == 0) != (jump == 0x28))
+        {
+            return;
+        }
+
+        until = std::min(until, _scheduler.next());
+        if (until <= _cycles)
+        {
+            return;
+        }
+
+        auto iterations = (until - _cycles) / SPIN_CYCLES;
+        if (iterations == 0)
+        {
+            return;
+        }
+
+        // Skipped iterations all load the current value, which A and F may not reflect yet.
+        _cpu.write(A, value);
+        and_flags(_cpu, value);
+
+        _cpu.refresh(iterations * SPIN_INSTRUCTIONS);
+        _cycles += iterations * SPIN_CYCLES;
+        _instructions += iterations * SPIN_INSTRUCTIONS;
+
+        if (_profiler != nullptr)
+        {
+            _profiler->retire(loop, iterations * SPIN_LOAD_CYCLES);
+            _profiler->retire(address_t(loop + 3), iterations * SPIN_AND_CYCLES);
+            _profiler->retire(address_t(loop + 5), iterations * SPIN_JUMP_CYCLES);
+        }
+    }
+
+    bool Machine::execute(uint64_t until)
+    {
+        // Only the interpreter reports individual instructions.
+        if (_profiler != nullptr || _coverage != nullptr)
+        {
+            return false;
+        }
+
+        if (_cycles >= _scheduler.next())
+        {
+            _scheduler.fire(_cycles);
+        }
+
+        if (_cpu.halted() || (_interrupt && _cpu.iff1() && !_deferred))
+        {
+            return false;
+        }
+
+        CompiledContext context{ _cpu, _bus, _scheduler, _interrupt, _cycles, until };
+        _compiledCycles = &context.cycles;
+        _compiled->run(context);
+        _compiledCycles = nullptr;
+
+        if (context.instructions == 0)
+        {
+            return false;
+        }
+
+        _cycles += context.cycles;
+        _instructions += context.instructions;
+        _deferred = context.deferred;
+
+        return true;
+    }
+}
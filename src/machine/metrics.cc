@@ -0,0 +1,143 @@
+#include "zasm/machine/metrics.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace zasm
+{
+    namespace
+    {
+        /**
+         * The counters published by a single thread.
+         */
+        struct Counters
+        {
+            std::atomic<uint64_t> instructions { 0 };
+            std::atomic<uint64_t> cycles { 0 };
+            std::atomic<uint64_t> nanoseconds { 0 };
+            std::atomic<uint64_t> reads { 0 };
+            std::atomic<uint64_t> writes { 0 };
+            std::atomic<uint64_t> spans { 0 };
+
+            [[nodiscard]] Metrics load() const noexcept
+            {
+                Metrics metrics;
+                metrics.instructions = instructions.load(std::memory_order_relaxed);
+                metrics.cycles = cycles.load(std::memory_order_relaxed);
+                metrics.nanoseconds = nanoseconds.load(std::memory_order_relaxed);
+                metrics.reads = reads.load(std::memory_order_relaxed);
+                metrics.writes = writes.load(std::memory_order_relaxed);
+                metrics.spans = spans.load(std::memory_order_relaxed);
+                return metrics;
+            }
+        };
+
+        /**
+         * Adds to a counter that is only ever written by the calling thread.
+         */
+        inline void add(std::atomic<uint64_t>& counter, uint64_t value) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<Counters>> threads;
+            Metrics exited;
+        };
+
+        Registry& registry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        /**
+         * The registration of the counters of a thread, kept until the thread exits.
+         */
+        struct Registration
+        {
+            std::shared_ptr<Counters> counters;
+
+            Registration()
+                : counters(std::make_shared<Counters>())
+            {
+                auto& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.threads.push_back(counters);
+            }
+
+            ~Registration()
+            {
+                auto& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.exited += counters->load();
+                r.threads.erase(std::remove(r.threads.begin(), r.threads.end(), counters), r.threads.end());
+            }
+        };
+    }
+
+    double Metrics::mhz() const noexcept
+    {
+        if (nanoseconds == 0)
+        {
+            return 0.0;
+        }
+
+        return double(cycles) * 1000.0 / double(nanoseconds);
+    }
+
+    Metrics& Metrics::operator+=(const Metrics& other)
+    {
+        instructions += other.instructions;
+        cycles += other.cycles;
+        nanoseconds += other.nanoseconds;
+        reads += other.reads;
+        writes += other.writes;
+        spans += other.spans;
+
+        if (components.size() < other.components.size())
+        {
+            components.resize(other.components.size());
+        }
+
+        for (size_t i = 0; i < other.components.size(); ++i)
+        {
+            components[i].reads += other.components[i].reads;
+            components[i].writes += other.components[i].writes;
+            components[i].spans += other.components[i].spans;
+        }
+
+        return *this;
+    }
+
+    void Metrics::publish(const Metrics& delta)
+    {
+        thread_local Registration registration;
+        auto& counters = *registration.counters;
+
+        add(counters.instructions, delta.instructions);
+        add(counters.cycles, delta.cycles);
+        add(counters.nanoseconds, delta.nanoseconds);
+        add(counters.reads, delta.reads);
+        add(counters.writes, delta.writes);
+        add(counters.spans, delta.spans);
+    }
+
+    Metrics Metrics::collect()
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        auto metrics = r.exited;
+        for (const auto& counters : r.threads)
+        {
+            metrics += counters->load();
+        }
+
+        return metrics;
+    }
+}
@@ -0,0 +1,242 @@
+#include "zasm/machine/profiler.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <string>
+
+namespace zasm
+{
+    namespace
+    {
+        constexpr size_t ROOT = 0;
+
+        /**
+         * The key identifying a routine called from a given frame.
+         */
+        inline uint64_t child_key(size_t parent, address_t routine) noexcept
+        {
+            return (uint64_t(parent) << 16u) | routine;
+        }
+
+        std::string routine_name(size_t frame, address_t routine)
+        {
+            if (frame == ROOT)
+            {
+                return "root";
+            }
+
+            char name[8];
+            std::snprintf(name, sizeof(name), "0x%04X", unsigned(routine));
+            return name;
+        }
+    }
+
+    Profiler::Profiler(uint64_t interval)
+        : _pages()
+        , _frames()
+        , _children()
+        , _current(ROOT)
+        , _depth(0)
+        , _overflow(0)
+        , _interval(std::max<uint64_t>(interval, 1))
+        , _countdown(0)
+        , _total(0)
+    {
+        reset();
+    }
+
+    void Profiler::retire(address_t address, size_t cycles)
+    {
+        auto& page = _pages[address >> 8u];
+        if (!page)
+        {
+            page = std::make_unique<Page>();
+        }
+
+        (*page)[address & 0xFFu] += cycles;
+        _total += cycles;
+
+        _countdown -= int64_t(cycles);
+        if (_countdown <= 0)
+        {
+            auto samples = 1 + uint64_t(-_countdown) / _interval;
+            _frames[_current].cycles += samples * _interval;
+            _countdown += int64_t(samples * _interval);
+        }
+    }
+
+    void Profiler::call(address_t routine)
+    {
+        if (_depth >= MAX_DEPTH)
+        {
+            _overflow += 1;
+            return;
+        }
+
+        auto key = child_key(_current, routine);
+        auto child = _children.find(key);
+
+        size_t frame;
+        if (child == _children.end())
+        {
+            frame = _frames.size();
+            _frames.push_back({ routine, _current, 0, 0 });
+            _children.emplace(key, frame);
+        }
+        else
+        {
+            frame = child->second;
+        }
+
+        _frames[frame].calls += 1;
+        _current = frame;
+        _depth += 1;
+    }
+
+    void Profiler::ret() noexcept
+    {
+        if (_overflow > 0)
+        {
+            _overflow -= 1;
+            return;
+        }
+
+        // Returning from the root happens when guests use `RET` as a computed jump, and is ignored.
+        if (_current != ROOT)
+        {
+            _current = _frames[_current].parent;
+            _depth -= 1;
+        }
+    }
+
+    void Profiler::reset()
+    {
+        for (auto& page : _pages)
+        {
+            page.reset();
+        }
+
+        _frames.clear();
+        _frames.push_back({ 0, ROOT, 0, 0 });
+        _children.clear();
+
+        _current = ROOT;
+        _depth = 0;
+        _overflow = 0;
+        _countdown = int64_t(_interval);
+        _total = 0;
+    }
+
+    uint64_t Profiler::cycles(address_t address) const noexcept
+    {
+        const auto& page = _pages[address >> 8u];
+        return page ? (*page)[address & 0xFFu] : 0;
+    }
+
+    uint64_t Profiler::total() const noexcept
+    {
+        return _total;
+    }
+
+    void Profiler::write_folded(std::ostream& output) const
+    {
+        std::vector<size_t> stack;
+
+        for (size_t frame = 0; frame < _frames.size(); ++frame)
+        {
+            if (_frames[frame].cycles == 0)
+            {
+                continue;
+            }
+
+            stack.clear();
+            for (auto current = frame; current != ROOT; current = _frames[current].parent)
+            {
+                stack.push_back(current);
+            }
+
+            output << routine_name(ROOT, 0);
+            for (auto it = stack.rbegin(); it != stack.rend(); ++it)
+            {
+                output << ';' << routine_name(*it, _frames[*it].routine);
+            }
+            output << ' ' << _frames[frame].cycles << '\n';
+        }
+    }
+
+    void Profiler::write_routines(std::ostream& output) const
+    {
+        struct Row
+        {
+            std::string name;
+            uint64_t calls;
+            uint64_t self;
+            uint64_t total;
+        };
+
+        // Children are always created after their parent, so a reverse walk accumulates the inclusive cycles.
+        std::vector<uint64_t> inclusive(_frames.size());
+        for (size_t frame = _frames.size(); frame-- > 0;)
+        {
+            inclusive[frame] += _frames[frame].cycles;
+            if (frame != ROOT)
+            {
+                inclusive[_frames[frame].parent] += inclusive[frame];
+            }
+        }
+
+        std::vector<Row> rows;
+        std::unordered_map<uint32_t, size_t> indices;
+
+        for (size_t frame = 0; frame < _frames.size(); ++frame)
+        {
+            const auto& current = _frames[frame];
+            auto key = frame == ROOT ? uint32_t(0x10000u) : uint32_t(current.routine);
+
+            auto index = indices.find(key);
+            if (index == indices.end())
+            {
+                index = indices.emplace(key, rows.size()).first;
+                rows.push_back({ routine_name(frame, current.routine), 0, 0, 0 });
+            }
+
+            auto& row = rows[index->second];
+            row.calls += current.calls;
+            row.self += current.cycles;
+
+            // Recursive calls are already accounted for by the outermost frame of the same routine.
+            auto recursive = false;
+            for (auto ancestor = current.parent; ancestor != ROOT; ancestor = _frames[ancestor].parent)
+            {
+                if (_frames[ancestor].routine == current.routine)
+                {
+                    recursive = true;
+                    break;
+                }
+            }
+
+            if (!recursive)
+            {
+                row.total += inclusive[frame];
+            }
+        }
+
+        std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+            return a.self > b.self;
+        });
+
+        output << std::left << std::setw(8) << "routine" << std::right
+               << std::setw(12) << "calls"
+               << std::setw(16) << "self"
+               << std::setw(16) << "total" << '\n';
+
+        for (const auto& row : rows)
+        {
+            output << std::left << std::setw(8) << row.name << std::right
+                   << std::setw(12) << row.calls
+                   << std::setw(16) << row.self
+                   << std::setw(16) << row.total << '\n';
+        }
+    }
+}
@@ -0,0 +1,262 @@
+#include "zasm/machine/runner.hh"
+
+#include "meta.hh"
+
+namespace zasm
+{
+    /**
+     * A bus component publishing the bytes written to it as output events, until its runner is destroyed.
+     */
+    class Runner::Port final : public BusComponent
+    {
+    private:
+        Runner* _runner;
+        address_t _address;
+
+    public:
+        Port(Runner& runner, address_t address)
+            : _runner(&runner)
+            , _address(address)
+        {
+        }
+
+        /**
+         * Ignores the writes made from now on, as the bus keeps its components after the runner is destroyed.
+         */
+        void disable() noexcept
+        {
+            _runner = nullptr;
+        }
+
+        [[nodiscard]] byte_t read(address_t address) const noexcept override
+        {
+            UNUSED(address);
+            return 0;
+        }
+
+        void write(address_t address, byte_t byte) noexcept override
+        {
+            if (_runner != nullptr)
+            {
+                _runner->publish(Event::Type::Output, address, byte);
+            }
+        }
+
+        [[nodiscard]] bool accept_write(address_t address) const noexcept override
+        {
+            return address == _address;
+        }
+    };
+
+    Runner::Runner(Machine& machine, Options options)
+        : _machine(machine)
+        , _options(options)
+        , _period(std::chrono::milliseconds(1))
+        , _commands(options.commands)
+        , _events(options.events)
+        , _dropped(0)
+        , _breakpoints(ADDRESS_SPACE, false)
+        , _breakpointCount(0)
+        , _paused(true)
+        , _resumed(false)
+        , _stopping(false)
+        , _thread()
+        , _port(nullptr)
+    {
+        if (_options.frequency != 0)
+        {
+            _period = std::chrono::nanoseconds(_options.slice * 1000000000u / _options.frequency);
+        }
+
+        if (_options.output)
+        {
+            _port = &_machine.bus().attach<Port>(*this, *_options.output);
+        }
+    }
+
+    Runner::~Runner()
+    {
+        stop();
+
+        if (_port != nullptr)
+        {
+            _port->disable();
+        }
+    }
+
+    void Runner::start()
+    {
+        if (!_thread.joinable())
+        {
+            _thread = std::thread(&Runner::loop, this);
+        }
+    }
+
+    void Runner::stop()
+    {
+        _stopping.store(true, std::memory_order_release);
+
+        if (_thread.joinable())
+        {
+            _thread.join();
+        }
+
+        _stopping.store(false, std::memory_order_relaxed);
+    }
+
+    void Runner::loop()
+    {
+        auto deadline = std::chrono::steady_clock::now();
+
+        while (!_stopping.load(std::memory_order_acquire))
+        {
+            Command command;
+            while (_commands.pop(command))
+            {
+                apply(command);
+            }
+
+            if (_paused)
+            {
+                std::this_thread::sleep_for(_period);
+                deadline = std::chrono::steady_clock::now();
+                continue;
+            }
+
+            execute(_options.slice);
+            publish(Event::Type::Frame, _machine.cpu().read(PC));
+
+            if (_options.frequency != 0)
+            {
+                // Falling behind by more than a time slice drops the lost time instead of catching up in a burst.
+                auto now = std::chrono::steady_clock::now();
+                deadline += _period;
+
+                if (deadline + _period < now)
+                {
+                    deadline = now;
+                }
+
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+    }
+
+    void Runner::apply(const Command& command)
+    {
+        switch (command.type)
+        {
+            case Command::Type::Pause:
+                _paused = true;
+                publish(Event::Type::Paused, _machine.cpu().read(PC));
+                break;
+            case Command::Type::Resume:
+                _paused = false;
+                _resumed = true;
+                break;
+            case Command::Type::Step:
+                _paused = true;
+                _resumed = true;
+                step_instructions(command.count);
+                break;
+            case Command::Type::Poke:
+                _machine.bus().write(command.address, command.value);
+                break;
+            case Command::Type::Input:
+                if (_options.input != nullptr)
+                {
+                    _options.input->append(command.value);
+                }
+                break;
+            case Command::Type::Breakpoint:
+                if (_breakpoints[command.address] != (command.value != 0))
+                {
+                    _breakpoints[command.address] = command.value != 0;
+                    _breakpointCount += command.value != 0 ? 1 : -1;
+                }
+                break;
+            case Command::Type::Snapshot:
+                _machine.snapshot();
+                publish(Event::Type::Snapshot, _machine.cpu().read(PC));
+                break;
+            case Command::Type::Restore:
+                _machine.restore();
+                break;
+        }
+    }
+
+    void Runner::execute(uint64_t cycles)
+    {
+        auto until = _machine.cycles() + cycles;
+
+        if (_breakpointCount == 0)
+        {
+            _machine.run(cycles);
+        }
+        else
+        {
+            while (_machine.cycles() < until && !stopped_at_breakpoint() && _machine.step() != 0)
+            {
+            }
+        }
+
+        // Only the first instruction after resuming is let past its breakpoint, even when the slice ran without any.
+        _resumed = false;
+
+        if (!_paused && _machine.cycles() < until)
+        {
+            _paused = true;
+            publish(Event::Type::Fault, _machine.cpu().read(PC));
+        }
+    }
+
+    void Runner::step_instructions(uint64_t count)
+    {
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            if (stopped_at_breakpoint())
+            {
+                return;
+            }
+
+            if (_machine.step() == 0)
+            {
+                publish(Event::Type::Fault, _machine.cpu().read(PC));
+                return;
+            }
+        }
+
+        publish(Event::Type::Paused, _machine.cpu().read(PC));
+    }
+
+    bool Runner::stopped_at_breakpoint()
+    {
+        // The instruction a machine resumes on never stops it, so that resuming from a breakpoint moves past it.
+        auto pc = _machine.cpu().read(PC);
+        auto resumed = std::exchange(_resumed, false);
+
+        if (resumed || !_breakpoints[pc])
+        {
+            return false;
+        }
+
+        _paused = true;
+        publish(Event::Type::Breakpoint, pc);
+
+        return true;
+    }
+
+    void Runner::publish(Event::Type type, address_t address, byte_t value) noexcept
+    {
+        Event event;
+        event.type = type;
+        event.cycle = _machine.cycles();
+        event.address = address;
+        event.value = value;
+
+        if (!_events.push(event))
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
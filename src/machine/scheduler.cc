@@ -0,0 +1,48 @@
+#include "zasm/machine/scheduler.hh"
+
+#include <algorithm>
+#include <utility>
+
+namespace zasm
+{
+    namespace
+    {
+        /**
+         * Orders the heap of events so that the earliest event is at its front.
+         */
+        template<typename Event>
+        bool later(const Event& a, const Event& b) noexcept
+        {
+            return a.cycle != b.cycle ? a.cycle > b.cycle : a.sequence > b.sequence;
+        }
+    }
+
+    Scheduler::Scheduler()
+        : _events()
+        , _sequence(0)
+        , _next(NEVER)
+    {
+    }
+
+    void Scheduler::schedule(uint64_t cycle, Action action)
+    {
+        _events.push_back({ cycle, _sequence++, std::move(action) });
+        std::push_heap(_events.begin(), _events.end(), later<Event>);
+
+        _next = _events.front().cycle;
+    }
+
+    void Scheduler::fire(uint64_t cycle)
+    {
+        while (!_events.empty() && _events.front().cycle <= cycle)
+        {
+            std::pop_heap(_events.begin(), _events.end(), later<Event>);
+            auto action = std::move(_events.back().action);
+            _events.pop_back();
+
+            _next = _events.empty() ? NEVER : _events.front().cycle;
+
+            action();
+        }
+    }
+}